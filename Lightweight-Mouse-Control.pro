@@ -1,4 +1,4 @@
-QT       += core gui widgets
+QT       += core gui widgets concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -26,7 +26,19 @@ SOURCES += \
     src/hotkeymanager.cpp \
     src/settingsdialog.cpp \
     src/compactwindow.cpp \
-    src/customspinbox.cpp
+    src/customspinbox.cpp \
+    src/pointereventsource.cpp \
+    src/capturethread.cpp \
+    src/pathstreamwriter.cpp \
+    src/capturestats.cpp \
+    src/capturecalibrator.cpp \
+    src/samplestore.cpp \
+    src/pathbuffer.cpp \
+    src/editlist.cpp \
+    src/editpathdialog.cpp \
+    src/pathcodec.cpp \
+    src/crc32c.cpp \
+    src/pathsummary.cpp
 
 # Header files
 HEADERS += \
@@ -38,7 +50,20 @@ HEADERS += \
     include/hotkeymanager.h \
     include/settingsdialog.h \
     include/compactwindow.h \
-    include/customspinbox.h
+    include/customspinbox.h \
+    include/pointereventsource.h \
+    include/capturethread.h \
+    include/spscringbuffer.h \
+    include/pathstreamwriter.h \
+    include/capturestats.h \
+    include/capturecalibrator.h \
+    include/samplestore.h \
+    include/pathbuffer.h \
+    include/editlist.h \
+    include/editpathdialog.h \
+    include/pathcodec.h \
+    include/crc32c.h \
+    include/pathsummary.h
 
 # UI files
 FORMS += \
@@ -47,7 +72,26 @@ FORMS += \
 
 # Windows-specific settings for global hotkeys and mouse control
 win32 {
-    LIBS += -luser32 -lgdi32
+    LIBS += -luser32 -lgdi32 -lwinmm
+}
+
+# Linux: X11 cursor queries for the capture thread, XInput2 raw motion events for event-driven recording
+unix:!macx {
+    CONFIG += link_pkgconfig
+    # Thread-safe cursor queries on a private X connection
+    packagesExist(x11) {
+        PKGCONFIG += x11
+        DEFINES += HAVE_X11
+    }
+    packagesExist(x11 xi) {
+        PKGCONFIG += xi
+        DEFINES += HAVE_XINPUT2
+    }
+}
+
+# macOS: CGEventGetLocation for cursor queries off the GUI thread
+macx {
+    LIBS += -framework ApplicationServices
 }
 
 # Default rules for deployment.
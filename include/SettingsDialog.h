@@ -12,9 +12,11 @@
 #include <QSpinBox>
 #include <QDoubleSpinBox>
 #include <QCheckBox>
+#include <QComboBox>
 #include <QKeySequenceEdit>
 #include <QSettings>
 #include <QTimer>
+#include "capturecalibrator.h"
 
 class SettingsDialog : public QDialog
 {
@@ -26,13 +28,47 @@ public:
     // Settings access
     QString getRecordingHotkey() const;
     int getRecordingInterval() const;
+    int getCaptureMode() const;
+    bool getStreamToDisk() const;
+    // Segment rollover limits for streamed recordings (0 = no limit)
+    qint64 getSegmentMaxBytes() const;
+    int getSegmentMaxPoints() const;
+    qint64 getSegmentMaxDurationMs() const;
+    // PathCodec id used for new files
+    int getPathCodec() const;
+    bool getSuppressStationary() const;
+    bool getAdaptiveRate() const;
+    bool getVelocityBoost() const;
+    bool getFlightRecorderEnabled() const;
+    int getFlightRecorderSeconds() const;
+    QString getFlightRecorderHotkey() const;
     double getDefaultPlaybackSpeed() const;
+    int getProgressRate() const;
     bool getMinimizeToTray() const;
+    qint64 getMemoryBudget() const;
+    double getMeasuredBytesPerSample() const;
+    double getCalibrationCpuBudget() const;
+    double getCalibrationJitterBound() const;
+    CalibrationResult getLastCalibration() const;
 
     void setRecordingHotkey(const QString& hotkey);
     void setRecordingInterval(int interval);
+    void setCaptureMode(int mode);
+    void setStreamToDisk(bool enabled);
+    void setSegmentLimits(qint64 maxBytes, int maxPoints, qint64 maxDurationMs);
+    void setPathCodec(int codecId);
+    void setSuppressStationary(bool enabled);
+    void setAdaptiveRate(bool enabled);
+    void setVelocityBoost(bool enabled);
+    void setFlightRecorderEnabled(bool enabled);
+    void setFlightRecorderSeconds(int seconds);
+    void setFlightRecorderHotkey(const QString& hotkey);
     void setDefaultPlaybackSpeed(double speed);
+    void setProgressRate(int hz);
     void setMinimizeToTray(bool minimize);
+    void setMemoryBudget(qint64 bytes);
+    // Recorded by the main window after each in-memory recording
+    void setMeasuredBytesPerSample(double bytes);
 
 signals:
     void settingsChanged();
@@ -43,6 +79,7 @@ private slots:
     void onRestoreDefaultsClicked();
     void onIntervalValueChanged(int value);
     void onIntervalEditingFinished();
+    void onCalibrateClicked();
 
 private:
     void setupUI();
@@ -51,13 +88,32 @@ private:
     void restoreDefaults();
     void showIntervalWarning(int interval);
     void updateMaxDurationDisplay();
+    void updateCalibrationDisplay(const CalibrationResult& result);
 
     // UI components
     QKeySequenceEdit *m_hotkeyEdit;
+    QKeySequenceEdit *m_flightHotkeyEdit;
     QSpinBox *m_intervalSpinBox;
+    QComboBox *m_captureModeComboBox;
+    QCheckBox *m_streamToDiskCheckBox;
+    QSpinBox *m_segmentSizeSpinBox;
+    QSpinBox *m_segmentPointsSpinBox;
+    QSpinBox *m_segmentMinutesSpinBox;
+    QComboBox *m_pathCodecComboBox;
+    QCheckBox *m_suppressStationaryCheckBox;
+    QCheckBox *m_adaptiveRateCheckBox;
+    QCheckBox *m_velocityBoostCheckBox;
+    QCheckBox *m_flightRecorderCheckBox;
+    QSpinBox *m_flightRecorderSecondsSpinBox;
     QDoubleSpinBox *m_speedSpinBox;
     QCheckBox *m_minimizeCheckBox;
+    QSpinBox *m_progressRateSpinBox;
+    QSpinBox *m_memoryBudgetSpinBox;
     QLabel *m_maxDurationLabel;
+    QDoubleSpinBox *m_cpuBudgetSpinBox;
+    QSpinBox *m_jitterBoundSpinBox;
+    QPushButton *m_calibrateButton;
+    QLabel *m_calibrationLabel;
 
     QPushButton *m_okButton;
     QPushButton *m_cancelButton;
@@ -0,0 +1,62 @@
+#ifndef CAPTURECALIBRATOR_H
+#define CAPTURECALIBRATOR_H
+
+#include <QList>
+#include <QString>
+#include <QSettings>
+
+// 单个候选采样间隔的测量结果
+struct CalibrationTrial
+{
+    int intervalMs;
+    double achievedRateHz;
+    double p99JitterUs;   // |p99 interval - target|
+    double cpuPercent;    // Capture thread CPU time / wall time while the trial ran
+    bool withinBudget;
+};
+
+// 校准结果：计时器精度、单次采样开销和推荐间隔
+struct CalibrationResult
+{
+    CalibrationResult();
+
+    bool isValid() const;
+    QString summary() const;
+
+    // Persisted so diagnostics can show the last run without re-measuring
+    void save(QSettings *settings) const;
+    static CalibrationResult load(QSettings *settings);
+
+    double clockResolutionUs;  // Smallest step of the monotonic clock
+    double sleepOvershootUs;   // Mean overshoot of a 1ms absolute sleep
+    double sampleCostUs;       // Mean cost of one cursor position read
+    double cpuBudgetPercent;
+    double jitterBoundPercent;
+    int recommendedIntervalMs; // 0 if no candidate met the budget
+    QList<CalibrationTrial> trials;
+};
+
+// 在本机上测量采集能力，推荐满足CPU预算和抖动上限的最小录制间隔
+// Runs the real CaptureThread at each candidate interval, so the numbers include
+// the same tick source and cursor query used while recording. Takes a few seconds, so
+// callers run it on a worker thread.
+class CaptureCalibrator
+{
+public:
+    static CalibrationResult calibrate(double cpuBudgetPercent, double jitterBoundPercent);
+
+    static QList<int> candidateIntervals();
+
+private:
+    static double measureClockResolutionUs();
+    static double measureSleepOvershootUs();
+    static double measureSampleCostUs();
+    static CalibrationTrial runTrial(int intervalMs);
+    static qint64 processCpuTimeNs();
+
+    // Each trial runs at least this long and collects at least MIN_TRIAL_SAMPLES intervals
+    static const int TRIAL_DURATION_MS = 250;
+    static const int MIN_TRIAL_SAMPLES = 10;
+};
+
+#endif // CAPTURECALIBRATOR_H
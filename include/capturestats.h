@@ -0,0 +1,73 @@
+#ifndef CAPTURESTATS_H
+#define CAPTURESTATS_H
+
+#include <QDataStream>
+#include <QString>
+#include <QVector>
+
+// 录制质量统计：实际采样间隔分布、迟到和丢失的节拍
+struct CaptureStats
+{
+    CaptureStats();
+
+    bool isValid() const;
+
+    // Poor captures should not be used for playback without review
+    bool isDegraded() const;
+
+    // Multi-line summary for the path details pane
+    QString summary() const;
+
+    int sampleCount;
+    qint64 targetIntervalUs; // 0 for event-driven capture
+    qint64 minIntervalUs;
+    qint64 p50IntervalUs;
+    qint64 p99IntervalUs;
+    qint64 maxIntervalUs;
+    int lateTicks;
+    int missedTicks;
+    double achievedRateHz;
+    bool adaptiveRate; // Polling period varied with motion; long idle intervals are expected
+};
+
+QDataStream& operator<<(QDataStream& stream, const CaptureStats& stats);
+QDataStream& operator>>(QDataStream& stream, CaptureStats& stats);
+
+// 在录制过程中累积采样间隔直方图（GUI线程调用）
+// Intervals go into log-linear buckets (32 per power of two, about 3% resolution),
+// so percentiles cost a fixed amount of memory regardless of recording length.
+class CaptureStatsCollector
+{
+public:
+    CaptureStatsCollector();
+
+    // targetIntervalNs is 0 when samples come from pointer events
+    void reset(qint64 targetIntervalNs, bool adaptiveRate = false);
+
+    // deadlineNs is the tick the sample was scheduled for (0 if unscheduled),
+    // missedTicks the number of deadlines skipped since the previous sample
+    void addSample(qint64 timestampNs, qint64 deadlineNs, int missedTicks);
+
+    CaptureStats stats() const;
+
+private:
+    static int bucketForUs(qint64 us);
+    static qint64 bucketValueUs(int bucket);
+    qint64 percentileUs(double fraction) const;
+
+    QVector<quint32> m_histogram;
+    qint64 m_targetIntervalNs;
+    bool m_adaptiveRate;
+    qint64 m_firstNs;
+    qint64 m_lastNs;
+    qint64 m_minIntervalNs;
+    qint64 m_maxIntervalNs;
+    int m_sampleCount;
+    int m_lateTicks;
+    int m_missedTicks;
+
+    static const int SUB_BUCKETS = 32;
+    static const int BUCKET_COUNT = SUB_BUCKETS * 28;
+};
+
+#endif // CAPTURESTATS_H
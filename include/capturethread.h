@@ -0,0 +1,117 @@
+#ifndef CAPTURETHREAD_H
+#define CAPTURETHREAD_H
+
+#include <QThread>
+#include <QPoint>
+#include <atomic>
+#include "spscringbuffer.h"
+
+// 采集线程产生的原始样本
+struct CaptureSample
+{
+    QPoint position;
+    qint64 timestampNs; // CaptureThread::monotonicNowNs() when the sample was taken
+    qint64 deadlineNs;  // Tick the sample was scheduled for, 0 for event-driven samples
+    int missedTicks;    // Deadlines skipped since the previous sample
+};
+
+typedef SpscRingBuffer<CaptureSample> CaptureQueue;
+
+#ifdef HAVE_X11
+struct _XDisplay;
+#endif
+
+// 原生光标位置查询：不经过Qt，可在创建它的线程上调用
+// Uses GetCursorPos on Windows, CGEventGetLocation on macOS and XQueryPointer on a
+// Display connection private to this reader on X11. Where none is available (e.g. a
+// Wayland session) isNative() is false and positions must be read on the GUI thread.
+class CursorReader
+{
+public:
+    CursorReader();
+    ~CursorReader();
+
+    bool isNative() const;
+    // False if there is no native query or it failed
+    bool read(QPoint& position);
+
+private:
+    Q_DISABLE_COPY(CursorReader)
+
+#ifdef HAVE_X11
+    _XDisplay *m_display;
+    unsigned long m_root;
+#endif
+    bool m_native;
+};
+
+// 采集线程：按固定周期读取光标位置并写入无锁队列，不依赖Qt事件循环
+class CaptureThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit CaptureThread(CaptureQueue *queue, QObject *parent = nullptr);
+    ~CaptureThread();
+
+    void startCapture();
+    void requestStop();
+
+    void setInterval(int intervalMs);
+    int interval() const;
+
+    // Adaptive rate: back off to IDLE_INTERVAL_MS after the cursor has been still for
+    // IDLE_AFTER_MS, return to interval() on the first moved sample, and with velocity
+    // boost sample at a quarter of interval() during fast strokes
+    void setAdaptive(bool adaptive);
+    bool isAdaptive() const;
+    void setVelocityBoost(bool boost);
+    bool velocityBoost() const;
+
+    // Read the cursor position on the GUI thread (QCursor::pos() is GUI-thread only)
+    static QPoint cursorPosition();
+
+    // GUI thread: where the capture thread has no native cursor query, give it the
+    // current position to sample. MouseRecorder calls this on every queue drain
+    void publishCursorPosition();
+    // Whether the running thread reads the cursor itself (false until it has started)
+    bool usesNativeCursor() const;
+    // CPU time the thread itself used in its last run, valid after wait(); -1 while
+    // running or where the platform has no per-thread CPU clock
+    qint64 cpuTimeNs() const;
+
+    // Monotonic clock shared by all capture producers (nanoseconds, arbitrary origin)
+    static qint64 monotonicNowNs();
+    // The tick wait: sleep until an absolute monotonicNowNs() deadline. With a stop
+    // flag the sleep is taken in slices of at most MAX_SLEEP_SLICE_MS and ends early
+    // once the flag is set
+    static void sleepUntilNs(qint64 deadlineNs, const std::atomic<bool> *stop = nullptr);
+
+protected:
+    void run() override;
+
+private:
+    CaptureQueue *m_queue;
+    qint64 adaptivePeriodNs(int intervalMs, qint64 sinceMoveNs, double speedPxPerSec);
+
+    std::atomic<int> m_intervalMs;
+    std::atomic<bool> m_adaptive;
+    std::atomic<bool> m_velocityBoost;
+    std::atomic<bool> m_stopRequested;
+    bool m_boosting;
+
+    // Fallback cursor position published by the GUI thread, packed as (x << 32) | y
+    std::atomic<qint64> m_publishedPosition;
+    std::atomic<bool> m_nativeCursor;
+    std::atomic<qint64> m_cpuTimeNs;
+
+public:
+    static const int IDLE_INTERVAL_MS = 100;
+    static const int IDLE_AFTER_MS = 500;
+    // Upper bound on how long requestStop() waits for a sleeping thread to notice
+    static const int MAX_SLEEP_SLICE_MS = 10;
+    // Boost above FAST_SPEED, drop back below half of it
+    static constexpr double FAST_SPEED_PX_PER_SEC = 3000.0;
+};
+
+#endif // CAPTURETHREAD_H
@@ -44,7 +44,7 @@ private slots:
     void onRecordButtonClicked();
     void onRecordingStarted();
     void onRecordingStopped();
-    void onPointRecorded(const MousePoint& point);
+    void onRecordingProgress(int pointCount, const MousePoint& lastPoint, qint64 elapsedMs);
 
     // Playback controls
     void onPlayButtonClicked();
@@ -82,9 +82,13 @@ private:
     int m_repeatCount;
 
     // State tracking
-    int m_recordedPointsCount;
     QString m_lastSavedPath;
-    QList<MousePoint> m_currentPlaybackPath;
+    // Last recording saved by this window, replayed from memory while it is m_lastSavedPath
+    PathHandle m_lastRecordedPath;
+    QString m_lastRecordedFile;
+    // The path to play is being loaded; further play requests are ignored
+    bool m_pathLoading;
+    EditedPath m_currentPlaybackPath;
     int m_remainingRepeats;
     int m_totalRepeats;
     QString m_recordingHotkey;
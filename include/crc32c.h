@@ -0,0 +1,12 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <QtGlobal>
+
+// CRC-32C（Castagnoli）校验：路径文件数据块的完整性检查
+// Uses the SSE4.2 crc32 instruction when the CPU has it (or the ARMv8 CRC extension
+// when the build targets it) and a table-driven loop otherwise; all give the same
+// result. Pass the previous result as crc to checksum data in pieces.
+quint32 crc32c(const void *data, qint64 size, quint32 crc = 0);
+
+#endif // CRC32C_H
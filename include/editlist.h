@@ -0,0 +1,117 @@
+#ifndef EDITLIST_H
+#define EDITLIST_H
+
+#include <QList>
+#include <QVector>
+#include <QStringList>
+#include <QDataStream>
+#include "pathbuffer.h"
+
+// 编辑列表中的一段：某个源路径中的连续点区间及其播放速度
+struct EditSegment
+{
+    int source;      // 0 = the path the edit list belongs to, others index EditList::sources()
+    int firstPoint;  // Inclusive range in the source path
+    int lastPoint;
+    double speed;    // Playback speed of this stretch relative to the recording
+
+    int pointCount() const { return lastPoint - firstPoint + 1; }
+};
+
+// 非破坏性编辑列表：按顺序排列的源区间，原始样本从不复制或修改
+// Edits address points of the edited result (output indices), not of the sources.
+// Every operation splits, trims or inserts segment descriptors, so its cost depends
+// on the number of segments rather than the number of points.
+class EditList
+{
+public:
+    EditList();
+    // The whole of a pointCount-point path, unedited
+    static EditList identity(int pointCount);
+
+    bool isEmpty() const;
+    // Points in the edited result
+    int size() const;
+    const QList<EditSegment>& segments() const;
+
+    // Paths spliced in from other files; source index i + 1 refers to sources()[i]
+    const QStringList& sources() const;
+    int addSource(const QString& filename);
+
+    // Keep only output points [first, last]
+    void trim(int first, int last);
+    // Remove output points [first, last]
+    void cut(int first, int last);
+    // Insert [firstPoint, lastPoint] of a source path before output point at
+    void splice(int at, int source, int firstPoint, int lastPoint, double speed = 1.0);
+    // Play output points [first, last] at speed
+    void setSpeed(int first, int last, double speed);
+
+    static const double MIN_SPEED;
+    static const double MAX_SPEED;
+
+private:
+    // Make output index a segment boundary and return the segment that starts there
+    int splitAt(int index);
+
+    QList<EditSegment> m_segments;
+    QStringList m_sources;
+
+    friend class EditedPath;
+    friend QDataStream& operator<<(QDataStream& stream, const EditList& edits);
+    friend QDataStream& operator>>(QDataStream& stream, EditList& edits);
+};
+
+QDataStream& operator<<(QDataStream& stream, const EditList& edits);
+QDataStream& operator>>(QDataStream& stream, EditList& edits);
+
+// 编辑后的路径：源路径句柄加编辑列表，按需计算每个点的位置和时间
+// Cheap to copy. The output timeline starts at 0; inside a segment, intervals are the
+// recorded ones divided by the segment speed, and a segment boundary takes the source
+// interval that led into the segment's first point (or, at a source's first point, the
+// interval after it).
+class EditedPath
+{
+public:
+    EditedPath();
+    // Unedited playback of a whole path
+    explicit EditedPath(const PathHandle& path);
+    // sources[0] is the edited path itself, followed by the edit list's spliced sources
+    EditedPath(const QVector<PathHandle>& sources, const EditList& edits);
+
+    bool isNull() const;
+    bool isEmpty() const;
+    int size() const;
+    qint64 durationNs() const;
+    const EditList& editList() const;
+    // Source handles indexed like EditSegment::source (null for a missing spliced file)
+    const QVector<PathHandle>& sources() const;
+
+    // Random access, O(log segments)
+    QPoint position(int index) const;
+    qint64 timestampNs(int index) const;
+    // First output point at or after timestampNs
+    int indexAtTime(qint64 timestampNs) const;
+
+    // Sequential access for the player: segment s covers output points
+    // [segmentOffset(s), segmentOffset(s) + segments()[s].pointCount())
+    int segmentCount() const;
+    const EditSegment& segment(int s) const;
+    const PathBuffer& segmentSource(int s) const;
+    int segmentOffset(int s) const;
+    qint64 segmentStartNs(int s) const;
+    // Output time of the point at offset within segment s
+    qint64 segmentTimestampNs(int s, int offset) const;
+
+private:
+    void buildTimeline();
+    int segmentForIndex(int index) const;
+
+    QVector<PathHandle> m_sources;
+    EditList m_edits;
+    QVector<int> m_segmentOffsets;
+    QVector<qint64> m_segmentStartNs;
+    qint64 m_durationNs;
+};
+
+#endif // EDITLIST_H
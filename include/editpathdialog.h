@@ -0,0 +1,67 @@
+#ifndef EDITPATHDIALOG_H
+#define EDITPATHDIALOG_H
+
+#include <QDialog>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+#include <QGroupBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QDoubleSpinBox>
+#include <QComboBox>
+#include <QListWidget>
+#include "pathmanager.h"
+#include "editlist.h"
+
+// 路径编辑对话框：剪切、裁剪、拼接和变速都只修改编辑列表
+// Ranges are entered as times on the edited timeline. Saving appends the edit list to
+// the path file; the recorded points stay as they are.
+class EditPathDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // path is the file's current edited path, as returned by PathManager::loadEditedPath()
+    EditPathDialog(PathManager *pathManager, const QString& filename,
+                   const EditedPath& path, QWidget *parent = nullptr);
+
+private slots:
+    void onTrimClicked();
+    void onCutClicked();
+    void onSpeedClicked();
+    void onSpliceClicked();
+    void onResetClicked();
+    void onSaveClicked();
+
+private:
+    void setupUI();
+    void updatePreview();
+    // Output points inside the selected time range; false if the range holds none
+    bool selectedRange(int& first, int& last) const;
+    bool isUnedited() const;
+
+    PathManager *m_pathManager;
+    QString m_filename;
+    QVector<PathHandle> m_sources;
+    EditList m_edits;
+    EditedPath m_preview;
+
+    // UI components
+    QLabel *m_summaryLabel;
+    QDoubleSpinBox *m_fromSpinBox;
+    QDoubleSpinBox *m_toSpinBox;
+    QDoubleSpinBox *m_speedSpinBox;
+    QComboBox *m_spliceComboBox;
+    QListWidget *m_segmentList;
+
+    QPushButton *m_trimButton;
+    QPushButton *m_cutButton;
+    QPushButton *m_speedButton;
+    QPushButton *m_spliceButton;
+    QPushButton *m_resetButton;
+    QPushButton *m_saveButton;
+    QPushButton *m_cancelButton;
+};
+
+#endif // EDITPATHDIALOG_H
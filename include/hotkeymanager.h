@@ -31,6 +31,8 @@ public:
     // Custom hotkey registration
     bool registerRecordingHotkey(const QString& keySequence);
     void unregisterRecordingHotkey();
+    bool registerFlightRecorderHotkey(const QString& keySequence);
+    void unregisterFlightRecorderHotkey();
 
     // Native event filter
     bool nativeEventFilter(const QByteArray &eventType, void *message, qintptr *result) override;
@@ -38,6 +40,7 @@ public:
 signals:
     void recordingHotkeyPressed();
     void stopPlaybackHotkeyPressed();
+    void flightRecorderHotkeyPressed();
     void hotkeyPressed(int id);
 
 private:
@@ -50,6 +53,7 @@ private:
     QWidget* m_mainWindow; // Store the main window pointer
     static const int RECORDING_HOTKEY_ID = 1;
     static const int STOP_PLAYBACK_HOTKEY_ID = 2;
+    static const int FLIGHT_RECORDER_HOTKEY_ID = 3;
 #endif
 };
 
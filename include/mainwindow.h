@@ -4,6 +4,7 @@
 #include <QMainWindow>
 #include <QListWidgetItem>
 #include <QMessageBox>
+#include <functional>
 #include "mouserecorder.h"
 #include "mouseplayer.h"
 #include "pathmanager.h"
@@ -32,8 +33,9 @@ private slots:
     void onRecordButtonClicked();
     void onRecordingStarted();
     void onRecordingStopped();
-    void onPointRecorded(const MousePoint& point);
+    void onRecordingProgress(int pointCount, const MousePoint& lastPoint, qint64 elapsedMs);
     void onRecordingLimitReached();
+    void onStreamingError(const QString& message);
 
     // Playback controls
     void onPlayButtonClicked();
@@ -42,6 +44,7 @@ private slots:
     void onPlaybackFinished();
     void onPlaybackStopped();
     void onSpeedChanged(double speed);
+    void onPlaybackProgress(int pointsPlayed, int totalPoints, const QPoint& position);
 
     // Path management
     void onPathSelectionChanged();
@@ -50,6 +53,7 @@ private slots:
     void onSelectAllClicked();
     void onRefreshPathsClicked();
     void onRenamePathClicked();
+    void onEditPathClicked();
     void onPathSaved(const QString& filename);
     void onPathDeleted(const QString& filename);
     void onPathsDeleted(const QStringList& filenames);
@@ -66,7 +70,9 @@ private slots:
 
     // Hotkey handling
     void onRecordingHotkeyPressed();
+    void onFlightRecorderHotkeyPressed();
     void registerHotkeysWhenReady();
+    void updateFlightRecorderHotkey();
 
     // Settings handling
     void onSettingsChanged();
@@ -82,6 +88,10 @@ private:
     void updateRecordButtonText();
     void loadSettings();
     void applySettings();
+    // Loads the selected path on a worker thread and calls onLoaded on the GUI thread
+    // if it loaded; failures are reported here
+    void loadSelectedPathAsync(const std::function<void(const PathLoadResult&)>& onLoaded);
+    void startPlayback(const EditedPath& path);
 
 protected:
     void showEvent(QShowEvent *event) override;
@@ -103,12 +113,17 @@ protected:
     CustomSpinBox *m_repeatSpinBox;
 
     // UI state
-    int m_recordedPointsCount;
     QString m_currentSelectedPath;
     bool m_hotkeysRegistered;
+    // A path is being loaded for playback or editing; further requests are ignored
+    bool m_pathLoading;
+
+    // Last in-memory recording and the file it was saved to, replayed without reloading
+    PathHandle m_lastRecordedPath;
+    QString m_lastRecordedFile;
 
     // Repeat playback state
-    QList<MousePoint> m_currentPlaybackPath;
+    EditedPath m_currentPlaybackPath;
     int m_remainingRepeats;
     int m_totalRepeats;
 };
@@ -5,12 +5,19 @@
 #include <QTimer>
 #include <QList>
 #include <QCursor>
-#include "mousepoint.h"
+#include <QElapsedTimer>
+#include "pathbuffer.h"
+#include "editlist.h"
 
 #ifdef Q_OS_WIN
 #include <windows.h>
 #endif
 
+// 按录制时间重放鼠标路径
+// Each point is scheduled against an absolute deadline on a monotonic clock rather than
+// as a chain of relative delays, so timer overshoot never accumulates and sub-millisecond
+// intervals keep their average rate. The precise timer is armed for whole milliseconds and
+// every point that has fallen due by the time it fires is played in one pass.
 class MousePlayer : public QObject
 {
     Q_OBJECT
@@ -18,31 +25,54 @@ class MousePlayer : public QObject
 public:
     explicit MousePlayer(QObject *parent = nullptr);
 
-    void playPath(const QList<MousePoint>& path);
+    // The player holds the handle for the duration of playback; the path is not copied
+    void playPath(const PathHandle& path);
+    // Plays an edit list straight from its source paths
+    void playPath(const EditedPath& path);
     void stopPlaying();
     bool isPlaying() const;
 
     void setPlaybackSpeed(double speed); // 1.0 = normal speed, 0.5 = half speed, 2.0 = double speed
     double playbackSpeed() const;
 
+    // Rate of playbackProgress notifications (Hz); positionChanged stays per-point
+    void setProgressRate(int hz);
+    int progressRate() const;
+
 signals:
     void playbackStarted();
     void playbackFinished();
     void playbackStopped();
     void positionChanged(const QPoint& position);
+    // Coalesced notification delivered at progressRate(), and once for the last point
+    void playbackProgress(int pointsPlayed, int totalPoints, const QPoint& position);
 
 private slots:
     void playNextPoint();
 
 private:
     void moveMouseTo(const QPoint& position);
+    void reportPosition(const QPoint& position);
+    void scheduleNextPoint();
+    void finishPlayback();
+    // Position on the recording's timeline (ns from the first point), scaled by speed
+    qint64 playbackOffsetNs() const;
 
     QTimer *m_playbackTimer;
-    QList<MousePoint> m_playbackPath;
+    EditedPath m_playbackPath;
+    // Output points played so far, and the cursor of the next one (segment, offset)
     int m_currentIndex;
+    int m_segment;
+    int m_segmentPoint;
     bool m_isPlaying;
     double m_playbackSpeed;
-    qint64 m_startTime;
+    // Timeline origin: playbackOffsetNs() = m_clockBaseNs + m_clock elapsed * speed.
+    // Rebased on speed changes so the new speed applies from the current position
+    QElapsedTimer m_clock;
+    qint64 m_clockBaseNs;
+    bool m_timerResolutionRaised;
+    QElapsedTimer m_lastProgress;
+    int m_progressIntervalMs;
 };
 
 #endif // MOUSEPLAYER_H
\ No newline at end of file
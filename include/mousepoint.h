@@ -2,36 +2,34 @@
 #define MOUSEPOINT_H
 
 #include <QPoint>
-#include <QDateTime>
-#include <QDataStream>
+#include <QtGlobal>
+#include <type_traits>
 
+// 鼠标轨迹点：位置 + 相对录制开始时刻的单调时钟偏移（纳秒）
+// Wall-clock time is kept once per recording (see MouseRecorder::recordingStartTime),
+// never per point, so timing is immune to wall-clock jumps and timezone cost.
 class MousePoint
 {
 public:
     MousePoint();
-    MousePoint(const QPoint& position, const QDateTime& timestamp);
-    MousePoint(int x, int y, const QDateTime& timestamp);
-    MousePoint(const QPoint& position, quint32 deltaMs);
-    MousePoint(int x, int y, quint32 deltaMs);
+    MousePoint(const QPoint& position, qint64 timestampNs);
+    MousePoint(int x, int y, qint64 timestampNs);
 
     QPoint position() const;
-    QDateTime timestamp() const;
-    qint64 delay() const;
-    quint32 deltaMs() const;
-    bool isRelativeTime() const;
+    qint64 timestampNs() const;
+    qint64 timestampUs() const;
+    qint64 timestampMs() const;
 
     void setPosition(const QPoint& position);
-    void setTimestamp(const QDateTime& timestamp);
-    void setDeltaMs(quint32 deltaMs);
-
-    friend QDataStream& operator<<(QDataStream& out, const MousePoint& point);
-    friend QDataStream& operator>>(QDataStream& in, MousePoint& point);
+    void setTimestampNs(qint64 timestampNs);
 
 private:
     QPoint m_position;
-    QDateTime m_timestamp;
-    quint32 m_deltaMs;
-    bool m_useRelativeTime;
+    qint64 m_timestampNs;
 };
 
-#endif // MOUSEPOINT_H
\ No newline at end of file
+// Samples are copied block-wise by the sample store and file writer
+static_assert(std::is_trivially_copyable<MousePoint>::value, "MousePoint must stay trivially copyable");
+static_assert(sizeof(MousePoint) == 16, "MousePoint is expected to be 16 bytes");
+
+#endif // MOUSEPOINT_H
@@ -5,42 +5,204 @@
 #include <QTimer>
 #include <QList>
 #include <QCursor>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QVector>
 #include "mousepoint.h"
+#include "capturethread.h"
+#include "capturestats.h"
+#include "samplestore.h"
+#include "pathmanager.h"
+
+class PointerEventSource;
+class PathStreamWriter;
 
 class MouseRecorder : public QObject
 {
     Q_OBJECT
 
 public:
+    // How samples are captured: timer polling or real pointer motion events
+    enum CaptureMode {
+        PollingCapture = 0,
+        EventCapture = 1
+    };
+
     explicit MouseRecorder(QObject *parent = nullptr);
+    ~MouseRecorder();
 
     void startRecording();
     void stopRecording();
     bool isRecording() const;
 
-    QList<MousePoint> getRecordedPath() const;
+    // Read-only view of the recorded points; valid until the next recording starts
+    SampleView recordedPath() const;
     void clearRecordedPath();
+    // Move the finished in-memory recording out of the recorder. The sample store is
+    // decoded once into the returned handle and released, so whoever saves and replays
+    // it shares that one copy. Afterwards recordedPath() is empty. Null while recording
+    // or when the recording was streamed to disk.
+    PathHandle takeRecordedPath();
+
+    // Wall-clock time of the recording start; point timestamps are offsets from it
+    QDateTime recordingStartTime() const;
+
+    // Total points of the current/last recording, including blocks already streamed to disk
+    int recordedPointCount() const;
+
+    // In-memory mode stops when the recording's heap usage reaches the budget.
+    // Usage is the sample store's estimate of its actual allocations (encoded blocks plus
+    // container and allocator overhead), not a point count times a fixed size.
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const;
+    qint64 recordedMemoryBytes() const;
+    // Bytes per stored sample including per-block overhead (0 until the first block is sealed)
+    double bytesPerSample() const;
+    // Time left before the budget is reached at the current sample rate, -1 if unknown
+    qint64 projectedRemainingMs() const;
+
+    // Streaming mode: with a target set, finished blocks are written to a new .mpath
+    // file while recording and the in-memory budget no longer applies
+    void setStreamingTarget(PathManager *pathManager);
+    PathManager* streamingTarget() const;
+    bool recordingWasStreamed() const;
+
+    // Streaming mode only: roll over to a new segment file when the current one reaches
+    // any of these limits (0 = no limit). Segments are named after the session start and
+    // listed in a .msession manifest written at stop. Size and duration are checked when
+    // a block is flushed, so a segment may exceed them by up to one block.
+    void setSegmentLimits(qint64 maxBytes, int maxPoints, qint64 maxDurationMs);
+    bool segmentationEnabled() const;
+    // Segments of the current/last streamed recording, including the open one
+    int segmentCount() const;
+
+    // Rate of recordingProgress notifications (Hz); pointRecorded stays per-point
+    void setProgressRate(int hz);
+    int progressRate() const;
 
     void setRecordingInterval(int intervalMs);
     int recordingInterval() const;
 
+    void setCaptureMode(CaptureMode mode);
+    CaptureMode captureMode() const;
+
+    // Polling only: slow down while the cursor is idle, optionally speed up on fast strokes
+    void setAdaptiveRate(bool adaptive);
+    bool adaptiveRate() const;
+    void setVelocityBoost(bool boost);
+    bool velocityBoost() const;
+
+    // Store only position changes; a hold is closed by the next change (or by one
+    // final sample at stop), so playback visits the same positions at the same times
+    void setSuppressStationary(bool suppress);
+    bool suppressStationary() const;
+    int suppressedSampleCount() const;
+
+    // Measured sampling quality of the current/last recording (all captured samples,
+    // before stationary suppression)
+    CaptureStats captureStats() const;
+
+    // Flight recorder: while idle, keep the last preRollSeconds of samples in a fixed
+    // preallocated ring. saveFlightRecording() turns the ring into the start of a normal
+    // recording that continues until stopRecording(); afterwards the ring is re-armed.
+    void startFlightRecorder(int preRollSeconds);
+    void stopFlightRecorder();
+    bool isFlightRecorderActive() const;
+    int flightRecorderSeconds() const;
+    bool saveFlightRecording();
+
+    // Replace the event source used by EventCapture (takes ownership), e.g. an event log replay
+    void setPointerEventSource(PointerEventSource *source);
+    PointerEventSource* pointerEventSource() const;
+
 signals:
     void recordingStarted();
     void recordingStopped();
+    // Per-point hook for consumers that need every sample; UI should use recordingProgress
     void pointRecorded(const MousePoint& point);
+    // Coalesced notification delivered at progressRate()
+    void recordingProgress(int pointCount, const MousePoint& lastPoint, qint64 elapsedMs);
     void recordingLimitReached();
+    void streamingError(const QString& message);
+    // A segment was closed and the next one opened
+    void segmentRolledOver(int segmentIndex);
 
 private slots:
-    void recordCurrentPosition();
+    void drainCapturedSamples();
 
 private:
-    QTimer *m_recordingTimer;
-    QList<MousePoint> m_recordedPath;
+    void drainQueue();
+    void drainIntoPreRoll();
+    bool startProducers();
+    void armFlightRecorder();
+    void resetRecordingState();
+    void openStreamingTarget();
+    void appendPoint(const MousePoint& point);
+    void appendSample(const MousePoint& point);
+    bool startEventCapture();
+    void stopProducers();
+    void flushStreamBlock();
+    void rollOverIfNeeded();
+    void finishSegment();
+    void emitProgress();
+
+    // GUI-side timer that drains the capture queue in batches
+    QTimer *m_drainTimer;
+    CaptureQueue m_sampleQueue;
+    CaptureThread *m_captureThread;
+    PointerEventSource *m_eventSource;
+    CaptureMode m_captureMode;
+    bool m_eventCaptureActive;
+    bool m_limitReached;
+    bool m_streamFailed;
+    SampleStore m_recordedPath;
+    MousePoint m_lastPoint;
+    int m_totalPointCount;
+    bool m_suppressStationary;
+    bool m_hasPendingHold;
+    MousePoint m_pendingHold;
+    int m_suppressedCount;
+    CaptureStatsCollector m_statsCollector;
+    bool m_flightRecorderActive;
+    bool m_flightRecorderArmed;
+    int m_flightRecorderSeconds;
+    QVector<CaptureSample> m_preRoll;
+    int m_preRollHead;
+    int m_preRollCount;
+    PathManager *m_streamingTarget;
+    PathStreamWriter *m_streamWriter;
+    bool m_recordingWasStreamed;
+    qint64 m_segmentMaxBytes;
+    int m_segmentMaxPoints;
+    qint64 m_segmentMaxDurationMs;
+    int m_segmentIndex;
+    QList<SessionSegment> m_segments;
+    QElapsedTimer m_lastStreamFlush;
+    QElapsedTimer m_lastProgress;
+    int m_progressIntervalMs;
+    QDateTime m_recordingStartTime;
+    qint64 m_sessionStartNs;
     bool m_isRecording;
     int m_recordingInterval;
+    qint64 m_memoryBudget;
+
+    // Drain period for the capture queue, independent of the sampling interval
+    static const int DRAIN_INTERVAL_MS = 10;
+    // Queue capacity: about a minute of 1ms samples if the GUI stalls
+    static const int SAMPLE_QUEUE_CAPACITY = 65536;
+
+    // Streaming mode: points per block written to disk, and the longest a partial block may wait
+    static const int STREAM_BLOCK_POINTS = 4096;
+    static const int STREAM_FLUSH_INTERVAL_MS = 2000;
+
+public:
+    // Longest flight recorder pre-roll
+    static const int MAX_PRE_ROLL_SECONDS = 120;
+    // Highest pointer event rate the pre-roll ring is sized for (8kHz gaming mice)
+    static const int MAX_EVENT_RATE_HZ = 8000;
 
-    // Maximum points limit (5 minutes at 1ms interval = 300,000 points)
-    static const int MAX_RECORDING_POINTS = 300000;
+    // Default in-memory budget, about 6.5 hours at 1ms with typical compression
+    static const qint64 DEFAULT_MEMORY_BUDGET = 128LL * 1024 * 1024;
 };
 
 #endif // MOUSERECORDER_H
\ No newline at end of file
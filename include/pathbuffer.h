@@ -0,0 +1,92 @@
+#ifndef PATHBUFFER_H
+#define PATHBUFFER_H
+
+#include <QVector>
+#include <QPoint>
+#include <QRect>
+#include <QSharedPointer>
+#include "mousepoint.h"
+
+class QFile;
+
+// 结构数组形式的鼠标路径：x、y和时间分别存放在连续数组中
+// Scans over one field (time for scheduling, x/y for bounds and transforms) touch only
+// that field's array, and the loops are simple enough for the compiler to vectorize.
+// Finished paths are passed around as a PathHandle rather than by value.
+//
+// A buffer can also be a read-only view of columns in a memory-mapped MPATH_V5 file
+// (see fromMapping()). Reads go straight to the mapping; the first modification copies
+// the columns into the buffer's own arrays and releases the mapping.
+class PathBuffer
+{
+public:
+    PathBuffer();
+    // View over count samples stored in a mapping of file, which the buffer keeps open
+    static PathBuffer fromMapping(const QSharedPointer<QFile>& file, const qint32 *x,
+                                  const qint32 *y, const qint64 *timestampNs, int count);
+    bool isMapped() const;
+
+    int size() const;
+    bool isEmpty() const;
+    void reserve(int count);
+    // Grows or shrinks to count samples; new samples are zero until written
+    void resize(int count);
+    void clear();
+
+    void append(int x, int y, qint64 timestampNs);
+    void append(const MousePoint& point);
+    void append(const MousePoint *points, int count);
+    // Appends count samples from separate columns
+    void append(const qint32 *x, const qint32 *y, const qint64 *timestampNs, int count);
+    // Appends other with its timestamps shifted by offsetNs
+    void append(const PathBuffer& other, qint64 offsetNs = 0);
+
+    // Element access builds the sample from the three arrays
+    MousePoint at(int index) const;
+    MousePoint operator[](int index) const { return at(index); }
+    MousePoint first() const;
+    MousePoint last() const;
+    QPoint position(int index) const;
+    qint64 timestampNs(int index) const;
+
+    // Raw column access for bulk consumers (serialization, playback scheduling)
+    const qint32* xData() const;
+    const qint32* yData() const;
+    const qint64* timestampData() const;
+    // Writable columns for filling a resized buffer in place, e.g. by parallel decoders.
+    // Fetch them before handing ranges out: the first call detaches a mapped buffer
+    qint32* writableXData();
+    qint32* writableYData();
+    qint64* writableTimestampData();
+
+    // Whole-path scans and transforms
+    qint64 durationNs() const;
+    QRect bounds() const;
+    void translate(int dx, int dy);
+    void shiftTime(qint64 offsetNs);
+
+private:
+    // Copies mapped columns into the owned arrays before a modification
+    void detach();
+
+    QVector<qint32> m_x;
+    QVector<qint32> m_y;
+    QVector<qint64> m_timestampNs;
+
+    // Set while the buffer is a view of a mapped file
+    QSharedPointer<QFile> m_mapping;
+    const qint32 *m_mappedX;
+    const qint32 *m_mappedY;
+    const qint64 *m_mappedTimestampNs;
+    int m_mappedCount;
+};
+
+// 共享的只读路径：加载一次，播放器、窗口和重复播放共用同一份数据
+// Holders can only read the path, so it is never copied or changed behind another
+// holder's back; it is freed when the last holder lets go. Null means no path.
+typedef QSharedPointer<const PathBuffer> PathHandle;
+
+// Moves a finished path into a new handle
+PathHandle makePathHandle(PathBuffer&& path);
+
+#endif // PATHBUFFER_H
@@ -0,0 +1,289 @@
+#ifndef PATHCODEC_H
+#define PATHCODEC_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtEndian>
+#include "pathbuffer.h"
+
+// 路径点编解码策略：整块编码和解码，不逐点经过QDataStream
+// Every policy provides
+//   static const quint8 ID;                  stored after the MPATH_V4 header
+//   static const int MIN_BYTES_PER_POINT;    bounds the point count a file size can hold
+//   static const char *name();
+//   static void encode(const qint32 *x, const qint32 *y, const qint64 *timestampUs, int count, QByteArray& out);
+//   static bool decode(const uchar *p, const uchar *end, int count, qint32 *x, qint32 *y, qint64 *timestampNs);
+// Timestamps are microsecond offsets from the file's first point. Blocks are encoded
+// independently, so any block decodes without the ones before it. decode() writes
+// count points to the columns it is given (so blocks can be decoded in parallel into
+// one preallocated path) and fails on truncated or overlong input instead of reading
+// past end; on failure the columns hold partial output.
+namespace PathCodec {
+
+// 有符号数的zigzag映射：小绝对值对应小无符号数
+inline quint64 zigzag(qint64 value)
+{
+    return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+}
+
+inline qint64 unzigzag(quint64 value)
+{
+    return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+// 32位版本：差值按2^32取模计算，任何int32坐标都能无损往返
+inline quint32 zigzag32(quint32 delta)
+{
+    return (delta << 1) ^ (0u - (delta >> 31));
+}
+
+inline quint32 unzigzag32(quint32 value)
+{
+    return (value >> 1) ^ (0u - (value & 1));
+}
+
+inline void putVarint(QByteArray& out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+// Bounds-checked: false if the varint runs past end or beyond 64 bits
+inline bool getVarint(const uchar *&p, const uchar *end, quint64& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uchar byte = *p++;
+        value |= static_cast<quint64>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 四舍五入的整数除法（纳秒到微秒、微秒到毫秒）
+inline qint64 divideRounded(qint64 value, qint64 divisor)
+{
+    return value >= 0 ? (value + divisor / 2) / divisor : -((-value + divisor / 2) / divisor);
+}
+
+// 定长编码：每点x、y（int32）和时间（int64微秒），小端
+// Largest on disk, but needs no decoding state and maps one record to one point.
+struct FixedWidthCodec
+{
+    static const quint8 ID = 1;
+    static const int BYTES_PER_POINT = 16;
+    static const int MIN_BYTES_PER_POINT = BYTES_PER_POINT;
+    static const char *name() { return "fixed-width"; }
+
+    static void encode(const qint32 *x, const qint32 *y, const qint64 *timestampUs, int count, QByteArray& out)
+    {
+        int start = out.size();
+        out.resize(start + count * BYTES_PER_POINT);
+        uchar *p = reinterpret_cast<uchar*>(out.data()) + start;
+        for (int i = 0; i < count; ++i, p += BYTES_PER_POINT) {
+            qToLittleEndian<qint32>(x[i], p);
+            qToLittleEndian<qint32>(y[i], p + 4);
+            qToLittleEndian<qint64>(timestampUs[i], p + 8);
+        }
+    }
+
+    static bool decode(const uchar *p, const uchar *end, int count, qint32 *x, qint32 *y, qint64 *timestampNs)
+    {
+        if (end - p != static_cast<qint64>(count) * BYTES_PER_POINT) {
+            return false;
+        }
+        for (int i = 0; i < count; ++i, p += BYTES_PER_POINT) {
+            x[i] = qFromLittleEndian<qint32>(p);
+            y[i] = qFromLittleEndian<qint32>(p + 4);
+            timestampNs[i] = qFromLittleEndian<qint64>(p + 8) * 1000;
+        }
+        return true;
+    }
+};
+
+// 差分变长编码：每点dx、dy（zigzag）和时间步长（微秒）的变长整数
+// Lossless; slow strokes sampled at a fixed rate take 3-4 bytes per point.
+struct DeltaVarintCodec
+{
+    static const quint8 ID = 2;
+    static const int MIN_BYTES_PER_POINT = 3;
+    static const char *name() { return "delta-varint"; }
+
+    static void encode(const qint32 *x, const qint32 *y, const qint64 *timestampUs, int count, QByteArray& out)
+    {
+        out.reserve(out.size() + count * 4 + 16);
+        qint32 previousX = 0;
+        qint32 previousY = 0;
+        qint64 previousUs = 0;
+        for (int i = 0; i < count; ++i) {
+            putVarint(out, zigzag(static_cast<qint64>(x[i]) - previousX));
+            putVarint(out, zigzag(static_cast<qint64>(y[i]) - previousY));
+            putVarint(out, zigzag(timestampUs[i] - previousUs));
+            previousX = x[i];
+            previousY = y[i];
+            previousUs = timestampUs[i];
+        }
+    }
+
+    static bool decode(const uchar *p, const uchar *end, int count, qint32 *x, qint32 *y, qint64 *timestampNs)
+    {
+        qint64 currentX = 0;
+        qint64 currentY = 0;
+        qint64 us = 0;
+        quint64 dx, dy, dt;
+        for (int i = 0; i < count; ++i) {
+            if (!getVarint(p, end, dx) || !getVarint(p, end, dy) || !getVarint(p, end, dt)) {
+                return false;
+            }
+            currentX += unzigzag(dx);
+            currentY += unzigzag(dy);
+            us += unzigzag(dt);
+            x[i] = static_cast<qint32>(currentX);
+            y[i] = static_cast<qint32>(currentY);
+            timestampNs[i] = us * 1000;
+        }
+        return p == end;
+    }
+};
+
+// 量化编码：与差分变长编码相同，但时间量化为毫秒（有损）
+// For recordings made at 1 ms or coarser intervals, where sub-millisecond timing is noise.
+struct QuantizedCodec
+{
+    static const quint8 ID = 3;
+    static const int MIN_BYTES_PER_POINT = 3;
+    static const char *name() { return "quantized (1 ms)"; }
+
+    static void encode(const qint32 *x, const qint32 *y, const qint64 *timestampUs, int count, QByteArray& out)
+    {
+        out.reserve(out.size() + count * 3 + 16);
+        qint32 previousX = 0;
+        qint32 previousY = 0;
+        qint64 previousMs = 0;
+        for (int i = 0; i < count; ++i) {
+            // Rounded cumulative offsets, so rounding error never accumulates
+            qint64 ms = divideRounded(timestampUs[i], 1000);
+            putVarint(out, zigzag(static_cast<qint64>(x[i]) - previousX));
+            putVarint(out, zigzag(static_cast<qint64>(y[i]) - previousY));
+            putVarint(out, zigzag(ms - previousMs));
+            previousX = x[i];
+            previousY = y[i];
+            previousMs = ms;
+        }
+    }
+
+    static bool decode(const uchar *p, const uchar *end, int count, qint32 *x, qint32 *y, qint64 *timestampNs)
+    {
+        qint64 currentX = 0;
+        qint64 currentY = 0;
+        qint64 ms = 0;
+        quint64 dx, dy, dt;
+        for (int i = 0; i < count; ++i) {
+            if (!getVarint(p, end, dx) || !getVarint(p, end, dy) || !getVarint(p, end, dt)) {
+                return false;
+            }
+            currentX += unzigzag(dx);
+            currentY += unzigzag(dy);
+            ms += unzigzag(dt);
+            x[i] = static_cast<qint32>(currentX);
+            y[i] = static_cast<qint32>(currentY);
+            timestampNs[i] = ms * 1000000;
+        }
+        return p == end;
+    }
+};
+
+// 差分+游程编码：时间步长按游程存储，坐标差分用Stream VByte格式以便SIMD解码
+// Block layout: <varint run count> then (zigzag step us, run length) varint pairs for
+// time, then the coordinate stream: one control byte per four values holding their
+// byte lengths (2 bits each), followed by the value bytes. Values are zigzag dx, dy
+// pairs as 32-bit integers, so a fixed-rate capture costs little more than 2.5 bytes
+// per point. The decoder expands four values per control byte with an SSSE3 shuffle
+// when the CPU has one and falls back to a scalar loop otherwise.
+struct DeltaRunLengthCodec
+{
+    static const quint8 ID = 4;
+    static const int MIN_BYTES_PER_POINT = 2;
+    static const char *name() { return "delta run-length"; }
+
+    static void encode(const qint32 *x, const qint32 *y, const qint64 *timestampUs, int count, QByteArray& out);
+    static bool decode(const uchar *p, const uchar *end, int count, qint32 *x, qint32 *y, qint64 *timestampNs);
+};
+
+// MPATH_V2/V3点记录（QPoint、bool、quint32步长，大端）：只用于读取旧文件
+// The first record's delta is ignored so offsets start at 0, as the QDataStream reader did.
+template <qint64 NsPerUnit>
+struct RelativeRecordCodec
+{
+    static const int BYTES_PER_POINT = 13;
+
+    static bool decode(const uchar *p, const uchar *end, int count, qint32 *x, qint32 *y, qint64 *timestampNs)
+    {
+        if (end - p < static_cast<qint64>(count) * BYTES_PER_POINT) {
+            return false;
+        }
+        qint64 units = 0;
+        for (int i = 0; i < count; ++i, p += BYTES_PER_POINT) {
+            if (p[8] != 1) {
+                return false;
+            }
+            if (i > 0) {
+                units += qFromBigEndian<quint32>(p + 9);
+            }
+            x[i] = qFromBigEndian<qint32>(p);
+            y[i] = qFromBigEndian<qint32>(p + 4);
+            timestampNs[i] = units * NsPerUnit;
+        }
+        return true;
+    }
+};
+
+typedef RelativeRecordCodec<1000000> MillisecondRecordCodec; // MPATH_V2
+typedef RelativeRecordCodec<1000> MicrosecondRecordCodec;    // MPATH_V3
+
+// 按编解码器ID调用fn(Codec())：新增编解码器只需在此登记
+// Returns false for an unknown id. This switch is the only place codecs are listed.
+template <typename Fn>
+bool withCodec(quint8 id, Fn&& fn)
+{
+    switch (id) {
+    case FixedWidthCodec::ID:
+        fn(FixedWidthCodec());
+        return true;
+    case DeltaVarintCodec::ID:
+        fn(DeltaVarintCodec());
+        return true;
+    case QuantizedCodec::ID:
+        fn(QuantizedCodec());
+        return true;
+    case DeltaRunLengthCodec::ID:
+        fn(DeltaRunLengthCodec());
+        return true;
+    default:
+        return false;
+    }
+}
+
+const quint8 DEFAULT_CODEC = DeltaRunLengthCodec::ID;
+
+// Not a block codec: selects the uncompressed MPATH_V5 column layout, which is
+// memory-mapped on load instead of decoded (see PathStreamWriter)
+const quint8 MAPPED_COLUMNS = 0;
+
+bool isKnown(quint8 id);
+QString name(quint8 id);
+int minBytesPerPoint(quint8 id);
+
+// Encodes points [first, first + count) of path as one block, timestamps relative to originNs
+bool encodeBlock(quint8 id, const PathBuffer& path, int first, int count, qint64 originNs, QByteArray& out);
+// Decodes a block of count points into the columns; safe to call from several threads
+bool decodeBlock(quint8 id, const QByteArray& data, int count, qint32 *x, qint32 *y, qint64 *timestampNs);
+
+} // namespace PathCodec
+
+#endif // PATHCODEC_H
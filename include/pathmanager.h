@@ -6,7 +6,37 @@
 #include <QString>
 #include <QDir>
 #include <QDateTime>
+#include <QDataStream>
+#include <QFile>
+#include <QMap>
+#include <QVector>
+#include <QFuture>
+#include <limits>
 #include "mousepoint.h"
+#include "capturestats.h"
+#include "samplestore.h"
+#include "pathbuffer.h"
+#include "editlist.h"
+#include "pathsummary.h"
+
+class PathStreamWriter;
+struct PathChunk;
+
+// 异步加载的结果：路径和加载时的错误信息
+struct PathLoadResult
+{
+    EditedPath path;
+    // What getLastError() would have reported after a synchronous load
+    QString error;
+};
+
+// 会话清单中的一个分段文件
+struct SessionSegment
+{
+    QString filename;
+    qint64 startOffsetNs; // Offset of the segment's first point from the session start
+    int pointCount;
+};
 
 class PathManager : public QObject
 {
@@ -16,22 +46,70 @@ public:
     explicit PathManager(QObject *parent = nullptr);
 
     // Save/Load functions
-    bool savePath(const QList<MousePoint>& path, const QString& name = QString());
-    QList<MousePoint> loadPath(const QString& filename);
+    bool savePath(const PathBuffer& path, const QString& name = QString(),
+                  const QDateTime& recordedAt = QDateTime(),
+                  const CaptureStats& captureStats = CaptureStats());
+    // Null if the file could not be read or has no points (see getLastError). Damaged
+    // chunks of an MPATH_V6/V7 file are skipped; getLastError then says what was lost
+    PathHandle loadPath(const QString& filename);
+    // Only the chunks overlapping [fromNs, toNs] (offsets from the first point), located
+    // through the chunk index; formats without chunks are loaded whole
+    PathHandle loadPathRange(const QString& filename, qint64 fromNs, qint64 toNs);
+
+    // Codec used for files saved from now on (a PathCodec id, or PathCodec::MAPPED_COLUMNS
+    // for memory-mapped MPATH_V5 files); loading follows each file's header
+    void setPathCodec(quint8 codecId);
+    quint8 pathCodec() const;
+
+    // Streaming save: the returned writer (owned by the caller until finishPathStream)
+    // keeps a valid file on disk after every append
+    PathStreamWriter* beginPathStream(const QDateTime& recordedAt, const QString& name = QString());
+    bool finishPathStream(PathStreamWriter *writer);
+
+    // Segmented sessions: a .msession manifest lists .mpath segments in order.
+    // loadPath() on a manifest returns the segments joined into one continuous path
+    bool saveSessionManifest(const QDateTime& sessionStart, const QList<SessionSegment>& segments);
+    QList<SessionSegment> getSessionSegments(const QString& manifestFilename) const;
+    static bool isSessionFile(const QString& filename);
 
     // Path management
     QStringList getAvailablePaths() const;
     bool deletePath(const QString& filename);
     bool deletePaths(const QStringList& filenames);
     bool renamePath(const QString& oldFilename, const QString& newName);
+    // Text for the path details pane. MPATH_V7 files are described from the header summary
+    // and one pass over the trailer sections; older files are walked as before
     QString getPathInfo(const QString& filename) const;
 
+    // Point count, duration, bounds and first/last point from the file header alone.
+    // Invalid for files saved before the summary was added (MPATH_V1 to V6), which have
+    // to be loaded to learn this; a session combines its segments' summaries
+    PathSummary getPathSummary(const QString& filename) const;
+
+    // Capture quality stored with the recording (invalid if the file has none)
+    CaptureStats getCaptureStats(const QString& filename) const;
+
+    // Non-destructive editing: the edit list is appended to the file as a trailer
+    // section and the newest one wins, so the recorded points are never rewritten.
+    // Saving an empty edit list restores the unedited recording
+    bool saveEditList(const QString& filename, const EditList& edits);
+    EditList getEditList(const QString& filename) const;
+    // Loads the path with its edit list applied; preloaded (if given) is used as the
+    // file's own points instead of reading them again
+    EditedPath loadEditedPath(const QString& filename, const PathHandle& preloaded = PathHandle());
+    // loadEditedPath() on the global thread pool, so reading and decoding a large file
+    // does not block the calling thread. The load uses its own error state and does not
+    // emit pathLoaded; this manager may be used normally while it runs
+    QFuture<PathLoadResult> loadEditedPathAsync(const QString& filename, const PathHandle& preloaded = PathHandle()) const;
+
     // Directory management
     void setDataDirectory(const QString& directory);
     QString dataDirectory() const;
 
     // Filename utilities
     QString generateDateBasedFilename() const;
+    // Segment names share the session's date-based stem: yyyy-MM-dd_hh-mm-ss_001.mpath
+    QString generateSegmentFilename(const QDateTime& sessionStart, int index) const;
     QString getDisplayName(const QString& filename) const;
 
     // Error handling
@@ -47,8 +125,49 @@ signals:
 private:
     QString m_dataDirectory;
     QString m_lastError;
+    quint8 m_codec;
     QString ensureDataDirectory();
     bool isValidPathFile(const QString& filename) const;
+    PathBuffer readPath(const QString& filename, qint64 fromNs = std::numeric_limits<qint64>::min(),
+                        qint64 toNs = std::numeric_limits<qint64>::max());
+    PathBuffer readSession(const QString& filename);
+    QString getSessionInfo(const QString& filename) const;
+    // Removes a path file; a session manifest takes its segments with it
+    bool removePathFile(const QString& filename);
+
+    // Trailer sections after the point data, keyed by tag; dataStart bounds the backwards walk
+    static QMap<QByteArray, QByteArray> readTrailerSections(QFile& file, qint64 dataStart);
+    // Newest payload stored under tag in a path file, empty if there is none
+    QByteArray readTrailerSection(const QString& filename, const char *tag) const;
+    // Trailer payload parsers; an empty or damaged payload gives an empty result
+    static EditList parseEditList(const QByteArray& payload, const QString& filename);
+    static CaptureStats parseCaptureStats(const QByteArray& payload);
+
+    // Summary block of an MPATH_V7 header, read after the codec id; invalid if it does
+    // not match the header's point count
+    static PathSummary readHeaderSummary(QDataStream& stream, int pointCount);
+    // Chunk count recorded in an index section, -1 if it is missing or fails its CRC
+    static int indexedChunkCount(const QByteArray& index);
+
+    // Maps (or, where mapping is unavailable, reads) the columns of an MPATH_V5 file
+    PathBuffer readColumns(const QString& fullPath, qint64 columnsOffset, int pointCount);
+
+    // Chunks of an MPATH_V6/V7 file from its index section; without a usable index the
+    // chunk headers are walked from dataStart and time ranges are left unbounded
+    static QVector<PathChunk> readChunkTable(QFile& file, qint64 dataStart, int pointCount, bool *indexed = nullptr);
+    // Decodes the chunks overlapping [fromNs, toNs]; chunks failing their CRC are skipped
+    // and their points counted in damagedPoints
+    static PathBuffer readChunks(QFile& file, quint8 codecId, const QVector<PathChunk>& chunks,
+                                 qint64 fromNs, qint64 toNs, int& damagedPoints);
+
+    // V1-V3 point record: QPoint (8) + bool (1) + quint32 delta (4); V1 records
+    // with an absolute QDateTime are longer. V4, V6 and V7 files use their codec's minimum
+    static const int MIN_POINT_RECORD_BYTES = 13;
+    // V5 point: x (4) + y (4) + timestamp (8) across the three columns
+    static const int MAPPED_POINT_BYTES = 16;
+
+    static const char SESSION_EXTENSION[];
+    static const char DATE_FILENAME_FORMAT[];
 };
 
 #endif // PATHMANAGER_H
\ No newline at end of file
@@ -0,0 +1,115 @@
+#ifndef PATHSTREAMWRITER_H
+#define PATHSTREAMWRITER_H
+
+#include <QFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QByteArray>
+#include <QPair>
+#include <QVector>
+#include "mousepoint.h"
+#include "samplestore.h"
+#include "pathbuffer.h"
+#include "capturestats.h"
+#include "pathcodec.h"
+#include "pathsummary.h"
+
+// MPATH_V6/V7分块索引中的一项
+struct PathChunk
+{
+    qint64 offset;  // File offset of the chunk header
+    int pointCount;
+    qint64 firstNs; // Time range of the chunk, relative to the file's first point
+    qint64 lastNs;
+};
+
+// 增量写入.mpath文件：每次追加一批点后更新文件头中的点数和摘要
+// The file is a valid MPATH_V7 file after every append(), so a crash while
+// recording loses at most the chunk that had not been appended yet.
+//
+// MPATH_V7 follows the header with the codec id (quint8), then a PathSummary block
+// (see pathsummary.h) patched together with the point count, and then independently
+// decodable chunks of <quint32 point count><quint32 byte size><quint32 CRC-32C>
+// <encoded points>; the CRC covers the count, the size and the encoded points. The
+// codec policy (see pathcodec.h) encodes each chunk in one pass; timestamps stay
+// microsecond offsets from the first point unless the codec quantizes them.
+// close() adds a chunk index trailer section (offset, point count and time range of
+// every chunk, then a CRC-32C of the index), so readers can seek to any time and skip
+// damaged chunks; files cut short by a crash have no index and are read in order.
+// MPATH_V6 files are the same without the summary block, and MPATH_V4 files have
+// blocks without the CRC; both are only read.
+//
+// With PathCodec::MAPPED_COLUMNS the file is MPATH_V5 instead: the header ends with
+// a quint32 offset of the columns, and from that 8-byte aligned offset the x (int32),
+// y (int32) and time (int64 ns from the first point) columns follow, little-endian,
+// so a reader can map them and use them in place. Columns cannot grow, so a V5
+// writer takes all points in a single append().
+//
+// Optional trailer sections follow the points and are written by close(). Each is
+// stored as <payload><quint32 payload size><8-byte tag>, so readers find them by
+// walking backwards from the end of the file; older readers stop after the points.
+class PathStreamWriter
+{
+public:
+    // Trailer section tags are 8 ASCII bytes starting with "MP"
+    static const char CAPTURE_STATS_TAG[];
+    static const char EDIT_LIST_TAG[];
+    static const char CHUNK_INDEX_TAG[];
+    static const int TRAILER_TAG_SIZE = 8;
+    // MPATH_V6/V7 chunk header: point count, byte size and CRC-32C
+    static const int CHUNK_HEADER_SIZE = 12;
+
+    PathStreamWriter();
+    ~PathStreamWriter();
+
+    // Codec (or PathCodec::MAPPED_COLUMNS) for the next open(); PathCodec::DEFAULT_CODEC until changed
+    void setCodec(quint8 codecId);
+    quint8 codec() const;
+
+    bool open(const QString& fullPath, const QDateTime& recordedAt);
+    bool append(const PathBuffer& points);
+    bool append(const SampleView& points);
+    bool close();
+
+    // Queue a trailer section to be written at close()
+    void addTrailerSection(const QByteArray& tag, const QByteArray& payload);
+    void setCaptureStats(const CaptureStats& stats);
+
+    bool isOpen() const;
+    int pointCount() const;
+    qint64 fileSize() const;
+    // Offsets of the first and last points written, for segment rollover and manifests
+    qint64 firstTimestampNs() const;
+    qint64 lastTimestampNs() const;
+    QString filePath() const;
+    QString errorString() const;
+
+private:
+    bool writeBlocks(const PathBuffer& points);
+    bool writeColumns(const PathBuffer& points);
+    template <typename T>
+    void writeLittleEndian(const T *values, int count);
+    bool checkpoint();
+    bool writeTrailerSections();
+    QByteArray chunkIndex() const;
+
+    // Larger appends are split so encoding and decoding never hold more than this
+    static const int MAX_BLOCK_POINTS = 4096;
+
+    QFile m_file;
+    QDataStream m_stream;
+    qint64 m_countOffset;
+    qint64 m_summaryOffset;
+    PathSummary m_summary;
+    int m_pointCount;
+    quint8 m_codec;
+    qint64 m_firstTimestampNs;
+    qint64 m_lastTimestampNs;
+    QVector<PathChunk> m_chunks;
+    QList<QPair<QByteArray, QByteArray>> m_trailerSections;
+    QString m_error;
+};
+
+#endif // PATHSTREAMWRITER_H
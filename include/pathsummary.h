@@ -0,0 +1,45 @@
+#ifndef PATHSUMMARY_H
+#define PATHSUMMARY_H
+
+#include <QDataStream>
+#include <QPoint>
+#include <QRect>
+#include <QString>
+#include "pathbuffer.h"
+
+// 路径摘要：点数、时长、外接矩形和首末点，保存在MPATH_V7文件头中
+// Lets the details pane and diagnostics describe a file without reading its points.
+// On disk it is a quint32 byte size followed by the fields; readers skip bytes beyond
+// the fields they know, so later versions can append fields without a new format.
+struct PathSummary
+{
+    PathSummary();
+
+    bool isValid() const;
+
+    // Adds points to the summary; originNs is the timestamp of the path's first point
+    void add(const PathBuffer& points, qint64 originNs);
+    static PathSummary fromPath(const PathBuffer& path);
+
+    // Average sampling rate over the whole path (0 if it has under two points)
+    double averageRateHz() const;
+
+    // Multi-line summary for the path details pane
+    QString summary() const;
+
+    int pointCount;
+    qint64 durationNs;
+    QRect bounds;
+    QPoint firstPoint;
+    QPoint lastPoint;
+
+    // Size of the fields written by this version, excluding the size field itself
+    static const int FIELDS_SIZE = 44;
+    // Size of the whole block in a file header
+    static const int BLOCK_SIZE = FIELDS_SIZE + 4;
+};
+
+QDataStream& operator<<(QDataStream& stream, const PathSummary& summary);
+QDataStream& operator>>(QDataStream& stream, PathSummary& summary);
+
+#endif // PATHSUMMARY_H
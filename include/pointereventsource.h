@@ -0,0 +1,113 @@
+#ifndef POINTEREVENTSOURCE_H
+#define POINTEREVENTSOURCE_H
+
+#include <QObject>
+#include <QPoint>
+#include <QList>
+#include <QString>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <atomic>
+#include "capturethread.h"
+
+class QThread;
+
+// 指针事件源基类 - 由真实的鼠标移动事件驱动录制，而不是定时轮询
+class PointerEventSource : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PointerEventSource(QObject *parent = nullptr);
+    virtual ~PointerEventSource();
+
+    virtual bool start() = 0;
+    virtual void stop() = 0;
+    virtual bool isRunning() const = 0;
+    virtual QString name() const = 0;
+
+    // Create the best native event source for this platform (nullptr if none)
+    static PointerEventSource* createNative(QObject *parent = nullptr);
+    static bool isNativeSupported();
+
+    // When a queue is set, events are pushed to it from the source's own thread
+    // instead of being emitted as pointerMoved signals
+    void setSampleQueue(CaptureQueue *queue);
+
+signals:
+    // Emitted once per pointer motion event, timestamped (CaptureThread::monotonicNowNs) on arrival
+    void pointerMoved(const QPoint& position, qint64 timestampNs);
+    void sourceError(const QString& message);
+
+protected:
+    void publish(const QPoint& position, qint64 timestampNs);
+
+private:
+    std::atomic<CaptureQueue*> m_queue;
+};
+
+// X11 XInput2 原始运动事件源：在独立线程中监听 XI_RawMotion
+class XInput2PointerSource : public PointerEventSource
+{
+    Q_OBJECT
+
+public:
+    explicit XInput2PointerSource(QObject *parent = nullptr);
+    ~XInput2PointerSource();
+
+    // Opens the display and selects raw motion before returning, so false means the
+    // caller should fall back to polling
+    bool start() override;
+    void stop() override;
+    bool isRunning() const override;
+    QString name() const override;
+
+    static bool isSupported();
+
+private:
+    void eventLoop();
+
+    QThread *m_thread;
+    std::atomic<bool> m_stopRequested;
+#ifdef HAVE_XINPUT2
+    // Opened and subscribed in start(), read by the event thread, closed in stop()
+    _XDisplay *m_display;
+    int m_opcode;
+#endif
+};
+
+// 事件日志回放源：按原始时间间隔重放记录的指针事件，用于测试
+// Log format: one event per line, "<offset_us> <x> <y>", '#' starts a comment
+class EventLogPointerSource : public PointerEventSource
+{
+    Q_OBJECT
+
+public:
+    explicit EventLogPointerSource(QObject *parent = nullptr);
+
+    bool loadLog(const QString& filename);
+    int eventCount() const;
+
+    bool start() override;
+    void stop() override;
+    bool isRunning() const override;
+    QString name() const override;
+
+private slots:
+    void emitDueEvents();
+
+private:
+    struct LoggedEvent {
+        qint64 offsetUs;
+        QPoint position;
+    };
+
+    QList<LoggedEvent> m_events;
+    QTimer *m_replayTimer;
+    QElapsedTimer m_replayClock;
+    qint64 m_startNs;
+    int m_nextEvent;
+    bool m_running;
+};
+
+#endif // POINTEREVENTSOURCE_H
@@ -0,0 +1,145 @@
+#ifndef SAMPLESTORE_H
+#define SAMPLESTORE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+#include <climits>
+#include <memory>
+#include "mousepoint.h"
+#include "pathbuffer.h"
+
+class SampleStore;
+
+// 录制数据的只读视图：按块访问，不复制整个录制
+// Valid until the store it came from is appended to, cleared or destroyed.
+class SampleView
+{
+public:
+    class const_iterator
+    {
+    public:
+        const_iterator(const SampleView *view, int index) : m_view(view), m_index(index) {}
+        const MousePoint& operator*() const { return m_view->at(m_index); }
+        const MousePoint* operator->() const { return &m_view->at(m_index); }
+        const_iterator& operator++() { ++m_index; return *this; }
+        bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+
+    private:
+        const SampleView *m_view;
+        int m_index;
+    };
+
+    SampleView();
+    explicit SampleView(const SampleStore *store);
+
+    int size() const;
+    bool isEmpty() const;
+    // Sequential access decodes each sealed block once; the reference is valid until
+    // the next access through this view's store
+    const MousePoint& at(int index) const;
+    const MousePoint& operator[](int index) const { return at(index); }
+    const MousePoint& first() const;
+    const MousePoint& last() const;
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    // Bulk access for file writers: decode one block into out (BLOCK_POINTS capacity);
+    // returns the points read, fewer than blockSize() only for a damaged block
+    int blockCount() const;
+    int blockSize(int block) const;
+    int readBlock(int block, MousePoint *out) const;
+
+    // Explicit copy for consumers that need an owning path (e.g. playback)
+    PathBuffer toPathBuffer() const;
+
+private:
+    const SampleStore *m_store;
+};
+
+// 分块追加的录制缓冲：写满的块被封存为差分编码的字节流，只有当前块保持未压缩
+// Sealed blocks store the first point raw followed by zigzag varints of dx, dy and the
+// change in time step, which is a few bytes per sample instead of sizeof(MousePoint).
+// append() does a bounded amount of work: a full block is swapped out for a spare one
+// and encoded a few points per append into a preallocated scratch buffer, and the
+// block table is a fixed directory of pages, so existing entries never move. The only
+// per-block costs are one exact-size allocation and copy when an encoding completes
+// and, every TABLE_PAGE_BLOCKS blocks, one table page.
+class SampleStore
+{
+public:
+    static const int BLOCK_POINTS = 4096;
+    // Raw blocks (active and being sealed) and the encoder scratch, allocated up front
+    static const qint64 FIXED_BYTES;
+
+    SampleStore();
+
+    SampleStore(const SampleStore&) = delete;
+    SampleStore& operator=(const SampleStore&) = delete;
+
+    void append(const MousePoint& point);
+    void clear();
+
+    int size() const;
+    bool isEmpty() const;
+    const MousePoint& at(int index) const;
+    const MousePoint& last() const;
+
+    int blockCount() const;
+    int blockSize(int block) const;
+    int readBlock(int block, MousePoint *out) const;
+
+    // Estimated heap bytes held for point data: sealed blocks with their QByteArray
+    // header and allocator overhead, the allocated table pages and the fixed buffers.
+    // The raw blocks are allocated in full up front, so a partly filled active block
+    // costs the same as a full one.
+    qint64 memoryBytes() const;
+    // Cost per sealed point including per-block overhead, 0 until the first block is sealed
+    double bytesPerSealedPoint() const;
+
+    SampleView view() const;
+
+private:
+    // Encodes up to count more points of the pending block; seals it when done
+    void encodePending(int count);
+    // Returns the points decoded (fewer than count if the block is damaged; the rest of
+    // out is filled with the last one)
+    static int decodeBlock(const QByteArray& data, MousePoint *out, int count);
+
+    QByteArray& sealedBlock(int block);
+    const QByteArray& sealedBlock(int block) const;
+
+    // Sealed blocks are always full. Block order: sealed, then the pending block while
+    // it is encoded, then the active block with the newest 1..BLOCK_POINTS points
+    std::unique_ptr<std::unique_ptr<QByteArray[]>[]> m_table;
+    int m_sealedCount;
+    std::unique_ptr<MousePoint[]> m_active;
+    int m_activeCount;
+    qint64 m_sealedBytes;
+    int m_tablePages;
+
+    // Full block being encoded (m_pendingEncoded points done so far, -1 if none)
+    std::unique_ptr<MousePoint[]> m_pending;
+    int m_pendingEncoded;
+    qint64 m_pendingStep;
+    QByteArray m_scratch;
+
+    // Most recently decoded sealed block, for at() and iteration
+    mutable QVector<MousePoint> m_cache;
+    mutable int m_cacheBlock;
+
+    // Points encoded per append; the pending block is sealed long before the next fills
+    static const int ENCODE_POINTS_PER_APPEND = 4;
+    // Worst case encoding: 16 byte first point, then dx and dy (5 bytes each) and the
+    // step change (10 bytes) per point
+    static const int MAX_ENCODED_BLOCK_BYTES = 16 + (BLOCK_POINTS - 1) * 20;
+    // Block table: TABLE_PAGES pages of TABLE_PAGE_BLOCKS entries cover every int index
+    static const int TABLE_PAGE_BLOCKS = 256;
+    static const int TABLE_PAGES = (INT_MAX / BLOCK_POINTS + 1) / TABLE_PAGE_BLOCKS + 1;
+    // Assumed malloc bookkeeping per heap allocation (a typical 64-bit allocator header)
+    static const int HEAP_CHUNK_OVERHEAD = 16;
+};
+
+#endif // SAMPLESTORE_H
@@ -0,0 +1,97 @@
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// 单生产者/单消费者无锁环形缓冲区
+// One thread may push() and one (possibly different) thread may pop(); no locks,
+// no allocation after construction. Capacity is rounded up to a power of two.
+template <typename T>
+class SpscRingBuffer
+{
+public:
+    explicit SpscRingBuffer(size_t capacity)
+        : m_head(0)
+        , m_tail(0)
+        , m_dropped(0)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Producer side: returns false (and counts a drop) when the ring is full
+    bool push(const T& value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) > m_mask) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_slots[head & m_mask] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: pop a single element
+    bool pop(T& value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = m_slots[tail & m_mask];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: copy up to maxCount elements into out, returns the number popped
+    size_t popBatch(T *out, size_t maxCount)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t available = m_head.load(std::memory_order_acquire) - tail;
+        if (available > maxCount) {
+            available = maxCount;
+        }
+        for (size_t i = 0; i < available; ++i) {
+            out[i] = m_slots[(tail + i) & m_mask];
+        }
+        m_tail.store(tail + available, std::memory_order_release);
+        return available;
+    }
+
+    // Consumer side: discard everything currently queued
+    void clear()
+    {
+        m_tail.store(m_head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+    size_t sizeApprox() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    size_t droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+    void resetDroppedCount() { m_dropped.store(0, std::memory_order_relaxed); }
+
+private:
+    std::vector<T> m_slots;
+    size_t m_mask;
+
+    // Keep producer and consumer indices on separate cache lines
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+    alignas(64) std::atomic<size_t> m_dropped;
+};
+
+#endif // SPSCRINGBUFFER_H
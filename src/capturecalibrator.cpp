@@ -0,0 +1,278 @@
+#include "capturecalibrator.h"
+#include "capturethread.h"
+#include "capturestats.h"
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QDebug>
+#include <cmath>
+#include <ctime>
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+// 校准结果构造函数
+CalibrationResult::CalibrationResult()
+    : clockResolutionUs(0.0)
+    , sleepOvershootUs(0.0)
+    , sampleCostUs(0.0)
+    , cpuBudgetPercent(0.0)
+    , jitterBoundPercent(0.0)
+    , recommendedIntervalMs(0)
+{
+}
+
+bool CalibrationResult::isValid() const
+{
+    return !trials.isEmpty();
+}
+
+// 格式化校准结果
+QString CalibrationResult::summary() const
+{
+    if (!isValid()) {
+        return QString("Not calibrated");
+    }
+
+    QString text = QString("Clock resolution: %1 us\n"
+                           "1ms sleep overshoot: %2 us\n"
+                           "Per-sample cost: %3 us\n")
+                   .arg(QString::number(clockResolutionUs, 'f', 2))
+                   .arg(QString::number(sleepOvershootUs, 'f', 0))
+                   .arg(QString::number(sampleCostUs, 'f', 2));
+
+    for (const CalibrationTrial& trial : trials) {
+        text += QString("  %1 ms: %2 Hz, p99 jitter %3 ms, CPU %4%%5\n")
+                .arg(trial.intervalMs, 3)
+                .arg(QString::number(trial.achievedRateHz, 'f', 1))
+                .arg(QString::number(trial.p99JitterUs / 1000.0, 'f', 2))
+                .arg(QString::number(trial.cpuPercent, 'f', 2))
+                .arg(trial.withinBudget ? "" : " (over budget)");
+    }
+
+    if (recommendedIntervalMs > 0) {
+        text += QString("Recommended interval: %1 ms (CPU budget %2%, jitter bound %3%)")
+                .arg(recommendedIntervalMs)
+                .arg(cpuBudgetPercent)
+                .arg(jitterBoundPercent);
+    } else {
+        text += QString("No interval met the CPU budget of %1% and jitter bound of %2%")
+                .arg(cpuBudgetPercent)
+                .arg(jitterBoundPercent);
+    }
+
+    return text;
+}
+
+// 保存校准结果到设置
+void CalibrationResult::save(QSettings *settings) const
+{
+    QStringList trialList;
+    for (const CalibrationTrial& trial : trials) {
+        trialList << QString("%1,%2,%3,%4,%5")
+                     .arg(trial.intervalMs)
+                     .arg(trial.achievedRateHz)
+                     .arg(trial.p99JitterUs)
+                     .arg(trial.cpuPercent)
+                     .arg(trial.withinBudget ? 1 : 0);
+    }
+
+    settings->beginGroup("calibration");
+    settings->setValue("clockResolutionUs", clockResolutionUs);
+    settings->setValue("sleepOvershootUs", sleepOvershootUs);
+    settings->setValue("sampleCostUs", sampleCostUs);
+    settings->setValue("cpuBudgetPercent", cpuBudgetPercent);
+    settings->setValue("jitterBoundPercent", jitterBoundPercent);
+    settings->setValue("recommendedIntervalMs", recommendedIntervalMs);
+    settings->setValue("trials", trialList);
+    settings->endGroup();
+}
+
+// 从设置加载上一次的校准结果
+CalibrationResult CalibrationResult::load(QSettings *settings)
+{
+    CalibrationResult result;
+
+    settings->beginGroup("calibration");
+    result.clockResolutionUs = settings->value("clockResolutionUs", 0.0).toDouble();
+    result.sleepOvershootUs = settings->value("sleepOvershootUs", 0.0).toDouble();
+    result.sampleCostUs = settings->value("sampleCostUs", 0.0).toDouble();
+    result.cpuBudgetPercent = settings->value("cpuBudgetPercent", 0.0).toDouble();
+    result.jitterBoundPercent = settings->value("jitterBoundPercent", 0.0).toDouble();
+    result.recommendedIntervalMs = settings->value("recommendedIntervalMs", 0).toInt();
+    QStringList trialList = settings->value("trials").toStringList();
+    settings->endGroup();
+
+    for (const QString& entry : trialList) {
+        QStringList fields = entry.split(',');
+        if (fields.size() != 5) {
+            continue;
+        }
+        CalibrationTrial trial;
+        trial.intervalMs = fields[0].toInt();
+        trial.achievedRateHz = fields[1].toDouble();
+        trial.p99JitterUs = fields[2].toDouble();
+        trial.cpuPercent = fields[3].toDouble();
+        trial.withinBudget = fields[4].toInt() != 0;
+        result.trials.append(trial);
+    }
+
+    return result;
+}
+
+// 执行校准：依次测量时钟、睡眠精度、采样开销和各候选间隔
+CalibrationResult CaptureCalibrator::calibrate(double cpuBudgetPercent, double jitterBoundPercent)
+{
+    CalibrationResult result;
+    result.cpuBudgetPercent = cpuBudgetPercent;
+    result.jitterBoundPercent = jitterBoundPercent;
+    result.clockResolutionUs = measureClockResolutionUs();
+    result.sleepOvershootUs = measureSleepOvershootUs();
+    result.sampleCostUs = measureSampleCostUs();
+
+    for (int intervalMs : candidateIntervals()) {
+        CalibrationTrial trial = runTrial(intervalMs);
+        trial.withinBudget = trial.cpuPercent <= cpuBudgetPercent &&
+                             trial.p99JitterUs <= intervalMs * 1000.0 * jitterBoundPercent / 100.0;
+        result.trials.append(trial);
+
+        // Candidates are ascending, so the first one within budget is the lowest
+        if (trial.withinBudget && result.recommendedIntervalMs == 0) {
+            result.recommendedIntervalMs = intervalMs;
+        }
+    }
+
+    qDebug().noquote() << "Capture calibration:\n" + result.summary();
+    return result;
+}
+
+// 候选采样间隔（毫秒，升序）
+QList<int> CaptureCalibrator::candidateIntervals()
+{
+    return QList<int>() << 1 << 2 << 5 << 10 << 16 << 20 << 50;
+}
+
+// 测量单调时钟的最小步进
+double CaptureCalibrator::measureClockResolutionUs()
+{
+    qint64 smallest = 0;
+    for (int i = 0; i < 1000; ++i) {
+        qint64 start = CaptureThread::monotonicNowNs();
+        qint64 next = start;
+        while (next == start) {
+            next = CaptureThread::monotonicNowNs();
+        }
+        if (smallest == 0 || next - start < smallest) {
+            smallest = next - start;
+        }
+    }
+    return smallest / 1000.0;
+}
+
+// 测量1ms绝对截止时间睡眠的平均超时（与采集线程的节拍等待和计时器精度设置相同）
+double CaptureCalibrator::measureSleepOvershootUs()
+{
+#ifdef Q_OS_WIN
+    timeBeginPeriod(1);
+#endif
+
+    const int iterations = 50;
+    qint64 totalOvershootNs = 0;
+    for (int i = 0; i < iterations; ++i) {
+        // Same absolute-deadline wait as a capture tick
+        qint64 deadline = CaptureThread::monotonicNowNs() + 1000000LL;
+        CaptureThread::sleepUntilNs(deadline);
+        totalOvershootNs += qMax(0LL, CaptureThread::monotonicNowNs() - deadline);
+    }
+
+#ifdef Q_OS_WIN
+    timeEndPeriod(1);
+#endif
+
+    return totalOvershootNs / 1000.0 / iterations;
+}
+
+// 测量读取一次光标位置的平均耗时（与采集线程相同的原生查询）
+double CaptureCalibrator::measureSampleCostUs()
+{
+    // Without a native query the capture thread reads a position published by the
+    // GUI thread, and the failed read measured here costs next to nothing as well
+    CursorReader reader;
+    QPoint position;
+    const int iterations = 2000;
+    qint64 start = CaptureThread::monotonicNowNs();
+    for (int i = 0; i < iterations; ++i) {
+        reader.read(position);
+    }
+    return (CaptureThread::monotonicNowNs() - start) / 1000.0 / iterations;
+}
+
+// 以指定间隔运行真实的采集线程，统计实际频率、抖动和CPU占用
+CalibrationTrial CaptureCalibrator::runTrial(int intervalMs)
+{
+    CalibrationTrial trial;
+    trial.intervalMs = intervalMs;
+    trial.achievedRateHz = 0.0;
+    trial.p99JitterUs = 0.0;
+    trial.cpuPercent = 0.0;
+    trial.withinBudget = false;
+
+    int durationMs = qMax(TRIAL_DURATION_MS, intervalMs * (MIN_TRIAL_SAMPLES + 1));
+    CaptureQueue queue(durationMs / intervalMs + 64);
+    CaptureThread thread(&queue);
+    thread.setInterval(intervalMs);
+
+    qint64 wallStart = CaptureThread::monotonicNowNs();
+    qint64 cpuStart = processCpuTimeNs();
+
+    thread.startCapture();
+    QThread::msleep(durationMs);
+    thread.requestStop();
+    thread.wait();
+
+    // The trial thread's own CPU time: the GUI thread, a flight recorder's capture
+    // thread or anything else running in the process is not charged to the trial
+    qint64 cpuNs = thread.cpuTimeNs();
+    if (cpuNs < 0) {
+        cpuNs = processCpuTimeNs() - cpuStart;
+    }
+    qint64 wallNs = CaptureThread::monotonicNowNs() - wallStart;
+
+    CaptureStatsCollector collector;
+    collector.reset(intervalMs * 1000000LL);
+    CaptureSample sample;
+    while (queue.pop(sample)) {
+        collector.addSample(sample.timestampNs, sample.deadlineNs, sample.missedTicks);
+    }
+
+    CaptureStats stats = collector.stats();
+    trial.achievedRateHz = stats.achievedRateHz;
+    trial.p99JitterUs = std::abs(double(stats.p99IntervalUs - stats.targetIntervalUs));
+    if (wallNs > 0) {
+        trial.cpuPercent = 100.0 * cpuNs / wallNs;
+    }
+    return trial;
+}
+
+// 进程CPU时间（纳秒）；仅在平台没有线程CPU时钟时使用，会计入进程内的其他线程
+qint64 CaptureCalibrator::processCpuTimeNs()
+{
+#ifdef Q_OS_WIN
+    FILETIME creation, exitTime, kernel, user;
+    if (GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernel, &user)) {
+        ULARGE_INTEGER k, u;
+        k.LowPart = kernel.dwLowDateTime;
+        k.HighPart = kernel.dwHighDateTime;
+        u.LowPart = user.dwLowDateTime;
+        u.HighPart = user.dwHighDateTime;
+        return static_cast<qint64>(k.QuadPart + u.QuadPart) * 100; // 100ns units
+    }
+    return 0;
+#elif defined(CLOCK_PROCESS_CPUTIME_ID)
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<qint64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#else
+    return static_cast<qint64>(std::clock()) * 1000000000LL / CLOCKS_PER_SEC;
+#endif
+}
@@ -0,0 +1,226 @@
+#include "capturestats.h"
+
+// 统计结果构造函数
+CaptureStats::CaptureStats()
+    : sampleCount(0)
+    , targetIntervalUs(0)
+    , minIntervalUs(0)
+    , p50IntervalUs(0)
+    , p99IntervalUs(0)
+    , maxIntervalUs(0)
+    , lateTicks(0)
+    , missedTicks(0)
+    , achievedRateHz(0.0)
+    , adaptiveRate(false)
+{
+}
+
+// 至少需要两个样本才有间隔数据
+bool CaptureStats::isValid() const
+{
+    return sampleCount > 1;
+}
+
+// 判断录制质量是否不合格：p99间隔超过目标的两倍，或丢失/迟到节拍过多
+bool CaptureStats::isDegraded() const
+{
+    if (!isValid() || targetIntervalUs <= 0) {
+        return false;
+    }
+
+    // Adaptive captures stretch the interval on purpose while idle
+    return (!adaptiveRate && p99IntervalUs > targetIntervalUs * 2) ||
+           missedTicks * 100 > sampleCount ||
+           lateTicks * 20 > sampleCount;
+}
+
+// 格式化统计摘要
+QString CaptureStats::summary() const
+{
+    if (!isValid()) {
+        return QString("Capture quality: not recorded");
+    }
+
+    auto ms = [](qint64 us) { return QString::number(us / 1000.0, 'f', 2); };
+
+    QString target = targetIntervalUs > 0
+                     ? QString("%1 ms%2").arg(ms(targetIntervalUs)).arg(adaptiveRate ? " (adaptive)" : "")
+                     : QString("pointer events");
+
+    QString text = QString("Capture quality: %1\n"
+                           "Target interval: %2\n"
+                           "Achieved rate: %3 Hz\n"
+                           "Interval min/p50/p99/max: %4 / %5 / %6 / %7 ms")
+                   .arg(isDegraded() ? "POOR - review before playback" : "OK")
+                   .arg(target)
+                   .arg(QString::number(achievedRateHz, 'f', 1))
+                   .arg(ms(minIntervalUs))
+                   .arg(ms(p50IntervalUs))
+                   .arg(ms(p99IntervalUs))
+                   .arg(ms(maxIntervalUs));
+
+    if (targetIntervalUs > 0) {
+        text += QString("\nLate ticks: %1\nMissed ticks: %2").arg(lateTicks).arg(missedTicks);
+    }
+
+    return text;
+}
+
+QDataStream& operator<<(QDataStream& stream, const CaptureStats& stats)
+{
+    stream << qint32(stats.sampleCount)
+           << stats.targetIntervalUs
+           << stats.minIntervalUs
+           << stats.p50IntervalUs
+           << stats.p99IntervalUs
+           << stats.maxIntervalUs
+           << qint32(stats.lateTicks)
+           << qint32(stats.missedTicks)
+           << stats.achievedRateHz
+           << stats.adaptiveRate;
+    return stream;
+}
+
+QDataStream& operator>>(QDataStream& stream, CaptureStats& stats)
+{
+    qint32 sampleCount, lateTicks, missedTicks;
+    stream >> sampleCount
+           >> stats.targetIntervalUs
+           >> stats.minIntervalUs
+           >> stats.p50IntervalUs
+           >> stats.p99IntervalUs
+           >> stats.maxIntervalUs
+           >> lateTicks
+           >> missedTicks
+           >> stats.achievedRateHz;
+    stats.sampleCount = sampleCount;
+    stats.lateTicks = lateTicks;
+    stats.missedTicks = missedTicks;
+
+    // Payloads written before adaptive polling end here
+    stats.adaptiveRate = false;
+    if (!stream.atEnd()) {
+        stream >> stats.adaptiveRate;
+    }
+    return stream;
+}
+
+// 统计收集器构造函数
+CaptureStatsCollector::CaptureStatsCollector()
+    : m_histogram(BUCKET_COUNT, 0)
+{
+    reset(0);
+}
+
+// 开始新的统计
+void CaptureStatsCollector::reset(qint64 targetIntervalNs, bool adaptiveRate)
+{
+    m_histogram.fill(0);
+    m_targetIntervalNs = targetIntervalNs;
+    m_adaptiveRate = adaptiveRate;
+    m_firstNs = 0;
+    m_lastNs = 0;
+    m_minIntervalNs = 0;
+    m_maxIntervalNs = 0;
+    m_sampleCount = 0;
+    m_lateTicks = 0;
+    m_missedTicks = 0;
+}
+
+// 记录一个样本：更新间隔直方图和节拍计数
+void CaptureStatsCollector::addSample(qint64 timestampNs, qint64 deadlineNs, int missedTicks)
+{
+    if (m_sampleCount == 0) {
+        m_firstNs = timestampNs;
+    } else {
+        qint64 intervalNs = qMax(0LL, timestampNs - m_lastNs);
+        if (m_sampleCount == 1 || intervalNs < m_minIntervalNs) {
+            m_minIntervalNs = intervalNs;
+        }
+        if (intervalNs > m_maxIntervalNs) {
+            m_maxIntervalNs = intervalNs;
+        }
+        m_histogram[bucketForUs(intervalNs / 1000)]++;
+    }
+
+    // A tick is late when the sample was taken more than a quarter period after its deadline
+    if (deadlineNs > 0 && m_targetIntervalNs > 0 &&
+        timestampNs - deadlineNs > m_targetIntervalNs / 4) {
+        m_lateTicks++;
+    }
+
+    m_missedTicks += missedTicks;
+    m_lastNs = timestampNs;
+    m_sampleCount++;
+}
+
+// 计算当前统计结果
+CaptureStats CaptureStatsCollector::stats() const
+{
+    CaptureStats stats;
+    stats.sampleCount = m_sampleCount;
+    stats.targetIntervalUs = m_targetIntervalNs / 1000;
+    stats.adaptiveRate = m_adaptiveRate;
+    stats.lateTicks = m_lateTicks;
+    stats.missedTicks = m_missedTicks;
+
+    if (m_sampleCount > 1) {
+        stats.minIntervalUs = m_minIntervalNs / 1000;
+        stats.maxIntervalUs = m_maxIntervalNs / 1000;
+        // Bucket midpoints can fall outside the exact extremes; keep the summary ordered
+        stats.p50IntervalUs = qBound(stats.minIntervalUs, percentileUs(0.50), stats.maxIntervalUs);
+        stats.p99IntervalUs = qBound(stats.minIntervalUs, percentileUs(0.99), stats.maxIntervalUs);
+
+        qint64 spanNs = m_lastNs - m_firstNs;
+        if (spanNs > 0) {
+            stats.achievedRateHz = (m_sampleCount - 1) * 1e9 / spanNs;
+        }
+    }
+
+    return stats;
+}
+
+// 间隔（微秒）映射到直方图桶：小于32us逐一计数，之后每个2的幂分32个桶
+int CaptureStatsCollector::bucketForUs(qint64 us)
+{
+    if (us < SUB_BUCKETS) {
+        return static_cast<int>(qMax(0LL, us));
+    }
+
+    int msb = 63;
+    while (!(us & (1LL << msb))) {
+        --msb;
+    }
+
+    int shift = msb - 5;
+    int bucket = shift * SUB_BUCKETS + static_cast<int>(us >> shift);
+    return qMin(bucket, BUCKET_COUNT - 1);
+}
+
+// 桶的代表值（桶中点）
+qint64 CaptureStatsCollector::bucketValueUs(int bucket)
+{
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+
+    int shift = bucket / SUB_BUCKETS - 1;
+    qint64 lower = static_cast<qint64>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+    return lower + ((1LL << shift) >> 1);
+}
+
+// 从直方图中取分位数
+qint64 CaptureStatsCollector::percentileUs(double fraction) const
+{
+    qint64 intervals = m_sampleCount - 1;
+    qint64 rank = qMax(1LL, static_cast<qint64>(intervals * fraction + 0.5));
+
+    qint64 seen = 0;
+    for (int i = 0; i < m_histogram.size(); ++i) {
+        seen += m_histogram[i];
+        if (seen >= rank) {
+            return bucketValueUs(i);
+        }
+    }
+    return m_maxIntervalNs / 1000;
+}
@@ -0,0 +1,459 @@
+#include "capturethread.h"
+#include <QCursor>
+#include <QCoreApplication>
+#include <QGuiApplication>
+#include <QDebug>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+#ifdef Q_OS_LINUX
+#include <time.h>
+#include <errno.h>
+#endif
+#ifdef Q_OS_MACOS
+#include <ApplicationServices/ApplicationServices.h>
+#endif
+#ifdef HAVE_X11
+// X11 headers define macros such as None/Bool/Status, so include them after Qt
+#include <X11/Xlib.h>
+#endif
+
+namespace {
+
+// 周期时钟：按绝对截止时间等待，避免累积漂移
+class TickSource
+{
+public:
+    // The wait returns early once *stop is set
+    TickSource(qint64 periodNs, const std::atomic<bool> *stop)
+        : m_periodNs(periodNs)
+        , m_missedTicks(0)
+        , m_stop(stop)
+    {
+        m_nextDeadlineNs = CaptureThread::monotonicNowNs() + m_periodNs;
+    }
+
+    void setPeriod(qint64 periodNs)
+    {
+        m_periodNs = periodNs;
+    }
+
+    // Change the period and place the next deadline one new period after fromNs
+    void reschedule(qint64 periodNs, qint64 fromNs)
+    {
+        m_periodNs = periodNs;
+        m_nextDeadlineNs = fromNs + periodNs;
+    }
+
+    qint64 period() const
+    {
+        return m_periodNs;
+    }
+
+    // Block until the next deadline and return it. Deadlines that already passed are
+    // skipped rather than replayed in a burst, so a stall never produces catch-up samples.
+    qint64 waitNextTick()
+    {
+        qint64 deadline = m_nextDeadlineNs;
+        CaptureThread::sleepUntilNs(deadline, m_stop);
+
+        qint64 now = CaptureThread::monotonicNowNs();
+        m_nextDeadlineNs += m_periodNs;
+        m_missedTicks = 0;
+        if (now >= m_nextDeadlineNs) {
+            qint64 missed = (now - m_nextDeadlineNs) / m_periodNs + 1;
+            m_nextDeadlineNs += missed * m_periodNs;
+            m_missedTicks = static_cast<int>(missed);
+        }
+        return deadline;
+    }
+
+    // Deadlines skipped by the last waitNextTick()
+    int missedTicks() const
+    {
+        return m_missedTicks;
+    }
+
+private:
+    qint64 m_periodNs;
+    qint64 m_nextDeadlineNs;
+    int m_missedTicks;
+    const std::atomic<bool> *m_stop;
+};
+
+// 调用线程自身的CPU时间（纳秒），不含进程中其他线程
+qint64 currentThreadCpuTimeNs()
+{
+#ifdef Q_OS_WIN
+    FILETIME creation, exitTime, kernel, user;
+    if (GetThreadTimes(GetCurrentThread(), &creation, &exitTime, &kernel, &user)) {
+        ULARGE_INTEGER k, u;
+        k.LowPart = kernel.dwLowDateTime;
+        k.HighPart = kernel.dwHighDateTime;
+        u.LowPart = user.dwLowDateTime;
+        u.HighPart = user.dwHighDateTime;
+        return static_cast<qint64>(k.QuadPart + u.QuadPart) * 100; // 100ns units
+    }
+    return 0;
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<qint64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#else
+    return -1;
+#endif
+}
+
+bool isGuiThread()
+{
+    return !QCoreApplication::instance() || QThread::currentThread() == QCoreApplication::instance()->thread();
+}
+
+// 光标位置打包为一个原子整数：高32位x，低32位y
+qint64 packPosition(const QPoint& position)
+{
+    return static_cast<qint64>((quint64(quint32(position.x())) << 32) | quint32(position.y()));
+}
+
+QPoint unpackPosition(qint64 packed)
+{
+    return QPoint(qint32(quint32(quint64(packed) >> 32)), qint32(quint32(quint64(packed))));
+}
+
+} // namespace
+
+// 光标读取器构造函数：X11下打开独立的显示连接
+CursorReader::CursorReader()
+#ifdef HAVE_X11
+    : m_display(nullptr)
+    , m_root(0)
+    , m_native(false)
+#else
+    : m_native(false)
+#endif
+{
+#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
+    m_native = true;
+#elif defined(HAVE_X11)
+    // Under Wayland an X connection only sees the pointer over X11 windows
+    if (QGuiApplication::platformName() == QLatin1String("xcb")) {
+        m_display = XOpenDisplay(nullptr);
+        if (m_display) {
+            m_root = DefaultRootWindow(m_display);
+            m_native = true;
+        }
+    }
+#endif
+}
+
+CursorReader::~CursorReader()
+{
+#ifdef HAVE_X11
+    if (m_display) {
+        XCloseDisplay(m_display);
+    }
+#endif
+}
+
+bool CursorReader::isNative() const
+{
+    return m_native;
+}
+
+// 读取光标位置
+bool CursorReader::read(QPoint& position)
+{
+#if defined(Q_OS_WIN)
+    POINT winPos;
+    if (GetCursorPos(&winPos)) {
+        position = QPoint(winPos.x, winPos.y);
+        return true;
+    }
+    return false;
+#elif defined(Q_OS_MACOS)
+    CGEventRef event = CGEventCreate(nullptr);
+    if (!event) {
+        return false;
+    }
+    CGPoint location = CGEventGetLocation(event);
+    CFRelease(event);
+    position = QPoint(qRound(location.x), qRound(location.y));
+    return true;
+#elif defined(HAVE_X11)
+    if (!m_display) {
+        return false;
+    }
+    Window rootReturn, childReturn;
+    int rootX, rootY, winX, winY;
+    unsigned int buttons;
+    if (!XQueryPointer(m_display, m_root, &rootReturn, &childReturn,
+                       &rootX, &rootY, &winX, &winY, &buttons)) {
+        return false;
+    }
+    position = QPoint(rootX, rootY);
+    return true;
+#else
+    Q_UNUSED(position)
+    return false;
+#endif
+}
+
+// 采集线程构造函数
+CaptureThread::CaptureThread(CaptureQueue *queue, QObject *parent)
+    : QThread(parent)
+    , m_queue(queue)
+    , m_intervalMs(50)
+    , m_adaptive(false)
+    , m_velocityBoost(false)
+    , m_stopRequested(false)
+    , m_boosting(false)
+    , m_publishedPosition(0)
+    , m_nativeCursor(false)
+    , m_cpuTimeNs(-1)
+{
+    setObjectName("MouseCaptureThread");
+}
+
+CaptureThread::~CaptureThread()
+{
+    requestStop();
+    wait();
+}
+
+// 启动采集线程（以最高优先级运行）
+void CaptureThread::startCapture()
+{
+    m_stopRequested = false;
+    m_nativeCursor = false;
+    m_cpuTimeNs = -1;
+    // Seed the fallback position so the first samples are valid without a native query
+    if (isGuiThread()) {
+        m_publishedPosition = packPosition(cursorPosition());
+    }
+    start(QThread::TimeCriticalPriority);
+}
+
+// 设置采样间隔（线程运行中也可调整）
+void CaptureThread::setInterval(int intervalMs)
+{
+    m_intervalMs = qMax(1, intervalMs);
+}
+
+// 获取采样间隔
+int CaptureThread::interval() const
+{
+    return m_intervalMs;
+}
+
+// 设置自适应采样频率
+void CaptureThread::setAdaptive(bool adaptive)
+{
+    m_adaptive = adaptive;
+}
+
+bool CaptureThread::isAdaptive() const
+{
+    return m_adaptive;
+}
+
+// 设置快速移动时是否提高采样频率
+void CaptureThread::setVelocityBoost(bool boost)
+{
+    m_velocityBoost = boost;
+}
+
+bool CaptureThread::velocityBoost() const
+{
+    return m_velocityBoost;
+}
+
+// 请求线程退出：正在进行的等待在一个睡眠片内返回
+void CaptureThread::requestStop()
+{
+    m_stopRequested = true;
+}
+
+// 在GUI线程读取当前光标位置：Windows下使用API以保持与回放一致
+QPoint CaptureThread::cursorPosition()
+{
+    Q_ASSERT(isGuiThread());
+#ifdef Q_OS_WIN
+    POINT winPos;
+    if (GetCursorPos(&winPos)) {
+        return QPoint(winPos.x, winPos.y);
+    }
+#endif
+    return QCursor::pos();
+}
+
+// 发布GUI线程读取的光标位置，供没有原生查询的采集线程使用
+void CaptureThread::publishCursorPosition()
+{
+    if (isRunning() && !m_nativeCursor) {
+        m_publishedPosition = packPosition(cursorPosition());
+    }
+}
+
+bool CaptureThread::usesNativeCursor() const
+{
+    return m_nativeCursor;
+}
+
+// 上一次运行中采集线程自身消耗的CPU时间
+qint64 CaptureThread::cpuTimeNs() const
+{
+    return m_cpuTimeNs;
+}
+
+// 单调时钟：Linux下为CLOCK_MONOTONIC（与clock_nanosleep同源），其他平台为steady_clock
+qint64 CaptureThread::monotonicNowNs()
+{
+#ifdef Q_OS_LINUX
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<qint64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// 睡眠到单调时钟上的绝对截止时间：Linux下为clock_nanosleep(TIMER_ABSTIME)，其他平台为短睡眠循环
+void CaptureThread::sleepUntilNs(qint64 deadlineNs, const std::atomic<bool> *stop)
+{
+    // Long waits are split into slices ending on absolute deadlines, so a stop request
+    // is seen within one slice and the final wake-up is as precise as a single sleep
+    for (;;) {
+        if (stop && *stop) {
+            return;
+        }
+        qint64 sliceEndNs = deadlineNs;
+        if (stop) {
+            sliceEndNs = qMin(deadlineNs, monotonicNowNs() + MAX_SLEEP_SLICE_MS * 1000000LL);
+        }
+#ifdef Q_OS_LINUX
+        timespec ts;
+        ts.tv_sec = sliceEndNs / 1000000000LL;
+        ts.tv_nsec = sliceEndNs % 1000000000LL;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+        }
+#else
+        qint64 remainingNs = sliceEndNs - monotonicNowNs();
+        while (remainingNs > 0) {
+            QThread::usleep(static_cast<unsigned long>(qMax(1LL, remainingNs / 1000)));
+            remainingNs = sliceEndNs - monotonicNowNs();
+        }
+#endif
+        if (sliceEndNs == deadlineNs) {
+            return;
+        }
+    }
+}
+
+// 自适应模式下选择下一个采样周期：静止时降频，移动时恢复，快速移动时加速
+qint64 CaptureThread::adaptivePeriodNs(int intervalMs, qint64 sinceMoveNs, double speedPxPerSec)
+{
+    qint64 baseNs = intervalMs * 1000000LL;
+
+    if (sinceMoveNs >= IDLE_AFTER_MS * 1000000LL) {
+        m_boosting = false;
+        return qMax(baseNs, IDLE_INTERVAL_MS * 1000000LL);
+    }
+
+    if (m_velocityBoost) {
+        if (speedPxPerSec > FAST_SPEED_PX_PER_SEC) {
+            m_boosting = true;
+        } else if (speedPxPerSec < FAST_SPEED_PX_PER_SEC / 2) {
+            m_boosting = false;
+        }
+        if (m_boosting) {
+            return qMax(1000000LL, baseNs / 4);
+        }
+    }
+
+    return baseNs;
+}
+
+// 线程主循环：等待时钟节拍，采样并写入队列
+void CaptureThread::run()
+{
+#ifdef Q_OS_WIN
+    // Raise the system timer resolution so 1ms sleeps are honoured
+    timeBeginPeriod(1);
+#endif
+
+    // Created on this thread: the X11 connection belongs to it alone
+    CursorReader reader;
+    m_nativeCursor = reader.isNative();
+
+    QPoint lastPosition = unpackPosition(m_publishedPosition);
+    // A failed native read repeats the previous position rather than inventing one
+    auto readPosition = [&]() {
+        if (!reader.isNative()) {
+            return unpackPosition(m_publishedPosition);
+        }
+        QPoint position;
+        return reader.read(position) ? position : lastPosition;
+    };
+    lastPosition = readPosition();
+
+    int intervalMs = m_intervalMs;
+    TickSource ticks(intervalMs * 1000000LL, &m_stopRequested);
+
+    qint64 lastSampleNs = monotonicNowNs();
+    qint64 lastMoveNs = lastSampleNs;
+    m_boosting = false;
+
+    int missedTicks = 0;
+    while (!m_stopRequested) {
+        qint64 deadlineNs = ticks.waitNextTick();
+        if (m_stopRequested) {
+            break;
+        }
+
+        CaptureSample sample;
+        sample.position = readPosition();
+        sample.timestampNs = monotonicNowNs();
+        sample.deadlineNs = deadlineNs;
+        sample.missedTicks = missedTicks;
+        m_queue->push(sample);
+
+        // Deadlines skipped while waiting for the next tick are charged to the next sample
+        missedTicks = ticks.missedTicks();
+
+        intervalMs = m_intervalMs;
+        if (m_adaptive) {
+            double speed = 0.0;
+            if (sample.position != lastPosition) {
+                qint64 dtNs = qMax(1LL, sample.timestampNs - lastSampleNs);
+                QPoint d = sample.position - lastPosition;
+                speed = std::sqrt(double(d.x()) * d.x() + double(d.y()) * d.y()) * 1e9 / dtNs;
+                lastMoveNs = sample.timestampNs;
+            }
+
+            // Speeding up takes effect from this sample rather than the already scheduled deadline
+            qint64 periodNs = adaptivePeriodNs(intervalMs, sample.timestampNs - lastMoveNs, speed);
+            if (periodNs < ticks.period()) {
+                ticks.reschedule(periodNs, sample.timestampNs);
+            } else if (periodNs != ticks.period()) {
+                ticks.setPeriod(periodNs);
+            }
+        } else if (ticks.period() != intervalMs * 1000000LL) {
+            ticks.setPeriod(intervalMs * 1000000LL);
+        }
+
+        lastPosition = sample.position;
+        lastSampleNs = sample.timestampNs;
+    }
+
+    // Every start() runs on a new OS thread, so its CPU clock covers this run alone
+    m_cpuTimeNs = currentThreadCpuTimeNs();
+
+#ifdef Q_OS_WIN
+    timeEndPeriod(1);
+#endif
+}
@@ -3,6 +3,7 @@
 #include <QMessageBox>
 #include <QCloseEvent>
 #include <QShowEvent>
+#include <QFutureWatcher>
 
 // 紧凑窗口构造函数：初始化UI和状态
 CompactWindow::CompactWindow(QWidget *parent)
@@ -15,7 +16,7 @@ CompactWindow::CompactWindow(QWidget *parent)
     , m_hotkeyManager(nullptr)
     , m_playbackSpeed(1.0)
     , m_repeatCount(1)
-    , m_recordedPointsCount(0)
+    , m_pathLoading(false)
     , m_remainingRepeats(0)
     , m_totalRepeats(1)
     , m_recordingHotkey("Ctrl+B")
@@ -211,7 +212,7 @@ void CompactWindow::connectSignals()
     connect(ui->recordButton, &QPushButton::clicked, this, &CompactWindow::onRecordButtonClicked);
     connect(m_recorder, &MouseRecorder::recordingStarted, this, &CompactWindow::onRecordingStarted);
     connect(m_recorder, &MouseRecorder::recordingStopped, this, &CompactWindow::onRecordingStopped);
-    connect(m_recorder, &MouseRecorder::pointRecorded, this, &CompactWindow::onPointRecorded);
+    connect(m_recorder, &MouseRecorder::recordingProgress, this, &CompactWindow::onRecordingProgress);
 
     // Playback signals
     connect(ui->playButton, &QPushButton::clicked, this, &CompactWindow::onPlayButtonClicked);
@@ -242,7 +243,6 @@ void CompactWindow::onRecordButtonClicked()
 // 录制开始事件处理
 void CompactWindow::onRecordingStarted()
 {
-    m_recordedPointsCount = 0;
     ui->recordButton->setChecked(true);
     updateRecordButton();
     updateStatus("Recording...");
@@ -255,12 +255,25 @@ void CompactWindow::onRecordingStopped()
     ui->recordButton->setChecked(false);
     updateRecordButton();
 
-    // Save the recorded path
-    QList<MousePoint> recordedPath = m_recorder->getRecordedPath();
+    // Streaming mode: the file was written while recording
+    if (m_recorder->recordingWasStreamed()) {
+        int pointCount = m_recorder->recordedPointCount();
+        updateStatus(pointCount > 0 ? QString("Saved: %1 points").arg(pointCount) : "No movement recorded");
+        return;
+    }
 
-    if (!recordedPath.isEmpty()) {
-        if (m_pathManager->savePath(recordedPath)) {
-            updateStatus(QString("Saved: %1 points").arg(recordedPath.size()));
+    // Take the recording out of the recorder; the same data is saved and kept for replay
+    PathHandle recordedPath = m_recorder->takeRecordedPath();
+    m_lastRecordedPath.clear();
+    m_lastRecordedFile.clear();
+
+    if (recordedPath) {
+        QString filename = m_pathManager->generateDateBasedFilename();
+        if (m_pathManager->savePath(*recordedPath, filename, m_recorder->recordingStartTime(),
+                                    m_recorder->captureStats())) {
+            m_lastRecordedPath = recordedPath;
+            m_lastRecordedFile = filename;
+            updateStatus(QString("Saved: %1 points").arg(recordedPath->size()));
         } else {
             updateStatus("Save failed!");
         }
@@ -269,16 +282,12 @@ void CompactWindow::onRecordingStopped()
     }
 }
 
-// 录制到新点事件处理
-void CompactWindow::onPointRecorded(const MousePoint& point)
+// 录制进度处理：按设置的刷新频率更新状态
+void CompactWindow::onRecordingProgress(int pointCount, const MousePoint& lastPoint, qint64 elapsedMs)
 {
-    Q_UNUSED(point)
-    m_recordedPointsCount++;
-
-    // Update status every 100 points to avoid too frequent updates
-    if (m_recordedPointsCount % 100 == 0) {
-        updateStatus(QString("Recording... (%1)").arg(m_recordedPointsCount));
-    }
+    Q_UNUSED(lastPoint)
+    Q_UNUSED(elapsedMs)
+    updateStatus(QString("Recording... (%1)").arg(pointCount));
 }
 
 // 播放按钮点击处理
@@ -289,19 +298,52 @@ void CompactWindow::onPlayButtonClicked()
         return;
     }
 
-    QList<MousePoint> path = m_pathManager->loadPath(m_lastSavedPath);
-    if (path.isEmpty()) {
-        updateStatus("Failed to load path");
+    if (m_pathLoading) {
         return;
     }
 
-    // 初始化重复播放状态
-    m_currentPlaybackPath = path;
-    m_totalRepeats = m_repeatCount;
-    m_remainingRepeats = m_totalRepeats - 1;
+    // Record, then replay: the path just saved is still in memory. Anything else is read
+    // and decoded on a worker thread so the window stays responsive
+    m_pathLoading = true;
+    ui->playButton->setEnabled(false);
+    updateStatus("Loading...");
+
+    QFutureWatcher<PathLoadResult> *watcher = new QFutureWatcher<PathLoadResult>(this);
+    connect(watcher, &QFutureWatcher<PathLoadResult>::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        m_pathLoading = false;
+
+        // Recording or playback may have been started from a hotkey while the file loaded;
+        // put the button and status back to match it instead of leaving "Loading..."
+        if (m_recorder && m_recorder->isRecording()) {
+            ui->playButton->setEnabled(false);
+            updateStatus("Recording...");
+            return;
+        }
+        if (m_player->isPlaying()) {
+            updatePlayButton();
+            ui->playButton->setEnabled(false);
+            updateStatus("Playing... (ESC to stop)");
+            return;
+        }
+
+        EditedPath path = watcher->result().path;
+        if (path.isNull()) {
+            updatePlayButton();
+            updateStatus("Failed to load path");
+            return;
+        }
 
-    m_player->setPlaybackSpeed(m_playbackSpeed);
-    m_player->playPath(path);
+        // 初始化重复播放状态
+        m_currentPlaybackPath = path;
+        m_totalRepeats = m_repeatCount;
+        m_remainingRepeats = m_totalRepeats - 1;
+
+        m_player->setPlaybackSpeed(m_playbackSpeed);
+        m_player->playPath(path);
+    });
+    watcher->setFuture(m_pathManager->loadEditedPathAsync(m_lastSavedPath,
+                           m_lastSavedPath == m_lastRecordedFile ? m_lastRecordedPath : PathHandle()));
 }
 
 // 停止按钮点击处理
@@ -346,7 +388,7 @@ void CompactWindow::onPlaybackFinished()
         }
 
         // 清空播放路径
-        m_currentPlaybackPath.clear();
+        m_currentPlaybackPath = EditedPath();
     }
 }
 
@@ -364,7 +406,7 @@ void CompactWindow::onPlaybackStopped()
     }
 
     // 清空播放路径
-    m_currentPlaybackPath.clear();
+    m_currentPlaybackPath = EditedPath();
     m_remainingRepeats = 0;
 }
 
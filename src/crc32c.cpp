@@ -0,0 +1,113 @@
+#include "crc32c.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CRC32C_SSE42
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CRC32C_TARGET_SSE42
+#else
+#define CRC32C_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace {
+
+// 反射多项式0x82F63B78的查表
+struct Crc32cTable
+{
+    quint32 entries[256];
+
+    Crc32cTable()
+    {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1)));
+            }
+            entries[i] = crc;
+        }
+    }
+};
+
+quint32 crc32cSoftware(const uchar *p, qint64 size, quint32 crc)
+{
+    static const Crc32cTable table;
+    for (qint64 i = 0; i < size; ++i) {
+        crc = table.entries[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef CRC32C_SSE42
+bool cpuHasSse42()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+// SSE4.2：每条指令处理8字节
+CRC32C_TARGET_SSE42
+quint32 crc32cSse42(const uchar *p, qint64 size, quint32 crc)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    quint64 crc64 = crc;
+    for (; size >= 8; p += 8, size -= 8) {
+        quint64 word;
+        memcpy(&word, p, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = static_cast<quint32>(crc64);
+#endif
+    for (; size >= 4; p += 4, size -= 4) {
+        quint32 word;
+        memcpy(&word, p, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+    }
+    for (; size > 0; ++p, --size) {
+        crc = _mm_crc32_u8(crc, *p);
+    }
+    return crc;
+}
+#endif
+
+#ifdef __ARM_FEATURE_CRC32
+quint32 crc32cArm(const uchar *p, qint64 size, quint32 crc)
+{
+    for (; size >= 8; p += 8, size -= 8) {
+        quint64 word;
+        memcpy(&word, p, sizeof(word));
+        crc = __crc32cd(crc, word);
+    }
+    for (; size > 0; ++p, --size) {
+        crc = __crc32cb(crc, *p);
+    }
+    return crc;
+}
+#endif
+
+} // namespace
+
+// 计算CRC-32C，可接着上一次的结果继续
+quint32 crc32c(const void *data, qint64 size, quint32 crc)
+{
+    const uchar *p = static_cast<const uchar*>(data);
+    crc = ~crc;
+#if defined(CRC32C_SSE42)
+    static const bool sse42 = cpuHasSse42();
+    crc = sse42 ? crc32cSse42(p, size, crc) : crc32cSoftware(p, size, crc);
+#elif defined(__ARM_FEATURE_CRC32)
+    crc = crc32cArm(p, size, crc);
+#else
+    crc = crc32cSoftware(p, size, crc);
+#endif
+    return ~crc;
+}
@@ -0,0 +1,335 @@
+#include "editlist.h"
+#include <algorithm>
+
+const double EditList::MIN_SPEED = 0.1;
+const double EditList::MAX_SPEED = 10.0;
+
+// 空编辑列表
+EditList::EditList()
+{
+}
+
+// 未编辑的完整路径
+EditList EditList::identity(int pointCount)
+{
+    EditList edits;
+    if (pointCount > 0) {
+        edits.m_segments.append(EditSegment{0, 0, pointCount - 1, 1.0});
+    }
+    return edits;
+}
+
+bool EditList::isEmpty() const
+{
+    return m_segments.isEmpty();
+}
+
+// 编辑结果中的点数
+int EditList::size() const
+{
+    int count = 0;
+    for (const EditSegment& segment : m_segments) {
+        count += segment.pointCount();
+    }
+    return count;
+}
+
+const QList<EditSegment>& EditList::segments() const
+{
+    return m_segments;
+}
+
+const QStringList& EditList::sources() const
+{
+    return m_sources;
+}
+
+// 登记拼接进来的源文件，返回其源索引
+int EditList::addSource(const QString& filename)
+{
+    int index = m_sources.indexOf(filename);
+    if (index < 0) {
+        m_sources.append(filename);
+        index = m_sources.size() - 1;
+    }
+    return index + 1;
+}
+
+// 保留区间 [first, last]
+void EditList::trim(int first, int last)
+{
+    cut(last + 1, size() - 1);
+    cut(0, first - 1);
+}
+
+// 删除区间 [first, last]
+void EditList::cut(int first, int last)
+{
+    first = qMax(0, first);
+    last = qMin(last, size() - 1);
+    if (first > last) {
+        return;
+    }
+
+    // Splitting at the later index never moves segments before it
+    int begin = splitAt(first);
+    int end = splitAt(last + 1);
+    m_segments.erase(m_segments.begin() + begin, m_segments.begin() + end);
+}
+
+// 在输出位置at之前插入源路径的区间
+void EditList::splice(int at, int source, int firstPoint, int lastPoint, double speed)
+{
+    if (firstPoint > lastPoint) {
+        return;
+    }
+
+    int index = splitAt(qBound(0, at, size()));
+    m_segments.insert(index, EditSegment{source, firstPoint, lastPoint, qBound(MIN_SPEED, speed, MAX_SPEED)});
+}
+
+// 设置区间 [first, last] 的播放速度
+void EditList::setSpeed(int first, int last, double speed)
+{
+    first = qMax(0, first);
+    last = qMin(last, size() - 1);
+    if (first > last) {
+        return;
+    }
+
+    int begin = splitAt(first);
+    int end = splitAt(last + 1);
+    for (int i = begin; i < end; ++i) {
+        m_segments[i].speed = qBound(MIN_SPEED, speed, MAX_SPEED);
+    }
+}
+
+// 在输出位置index处切分片段，返回从该位置开始的片段下标
+int EditList::splitAt(int index)
+{
+    int offset = 0;
+    for (int i = 0; i < m_segments.size(); ++i) {
+        int count = m_segments[i].pointCount();
+        if (index == offset) {
+            return i;
+        }
+        if (index < offset + count) {
+            EditSegment tail = m_segments[i];
+            tail.firstPoint += index - offset;
+            m_segments[i].lastPoint = tail.firstPoint - 1;
+            m_segments.insert(i + 1, tail);
+            return i + 1;
+        }
+        offset += count;
+    }
+    return m_segments.size();
+}
+
+QDataStream& operator<<(QDataStream& stream, const EditList& edits)
+{
+    stream << quint8(1) << edits.m_sources << qint32(edits.m_segments.size());
+    for (const EditSegment& segment : edits.m_segments) {
+        stream << qint32(segment.source)
+               << qint32(segment.firstPoint)
+               << qint32(segment.lastPoint)
+               << segment.speed;
+    }
+    return stream;
+}
+
+QDataStream& operator>>(QDataStream& stream, EditList& edits)
+{
+    edits = EditList();
+
+    quint8 version;
+    qint32 count;
+    stream >> version >> edits.m_sources >> count;
+    if (version != 1 || count < 0) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+        return stream;
+    }
+
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        qint32 source, firstPoint, lastPoint;
+        double speed;
+        stream >> source >> firstPoint >> lastPoint >> speed;
+        edits.m_segments.append(EditSegment{source, firstPoint, lastPoint, speed});
+    }
+    return stream;
+}
+
+// 空的编辑后路径
+EditedPath::EditedPath()
+    : m_durationNs(0)
+{
+}
+
+// 未编辑的完整路径
+EditedPath::EditedPath(const PathHandle& path)
+    : m_durationNs(0)
+{
+    m_sources.append(path);
+    m_edits = EditList::identity(path ? path->size() : 0);
+    buildTimeline();
+}
+
+// 源路径加编辑列表
+EditedPath::EditedPath(const QVector<PathHandle>& sources, const EditList& edits)
+    : m_sources(sources)
+    , m_edits(edits)
+    , m_durationNs(0)
+{
+    buildTimeline();
+}
+
+bool EditedPath::isNull() const
+{
+    return m_sources.isEmpty() || !m_sources.first();
+}
+
+bool EditedPath::isEmpty() const
+{
+    return m_edits.isEmpty();
+}
+
+int EditedPath::size() const
+{
+    return m_segmentOffsets.isEmpty() ? 0
+           : m_segmentOffsets.last() + m_edits.segments().last().pointCount();
+}
+
+qint64 EditedPath::durationNs() const
+{
+    return m_durationNs;
+}
+
+const EditList& EditedPath::editList() const
+{
+    return m_edits;
+}
+
+const QVector<PathHandle>& EditedPath::sources() const
+{
+    return m_sources;
+}
+
+// 去掉引用无效源或越界区间的片段，并计算每段在输出时间轴上的起点
+void EditedPath::buildTimeline()
+{
+    // Persisted edit lists may outlive a spliced file or refer to a shorter path
+    QList<EditSegment>& segments = m_edits.m_segments;
+    for (int i = segments.size() - 1; i >= 0; --i) {
+        EditSegment& segment = segments[i];
+        bool valid = segment.source >= 0 && segment.source < m_sources.size() && m_sources[segment.source];
+        if (valid) {
+            segment.firstPoint = qMax(0, segment.firstPoint);
+            segment.lastPoint = qMin(segment.lastPoint, m_sources[segment.source]->size() - 1);
+            segment.speed = qBound(EditList::MIN_SPEED, segment.speed, EditList::MAX_SPEED);
+            valid = segment.firstPoint <= segment.lastPoint;
+        }
+        if (!valid) {
+            segments.removeAt(i);
+        }
+    }
+
+    m_segmentOffsets.clear();
+    m_segmentStartNs.clear();
+    m_segmentOffsets.reserve(segments.size());
+    m_segmentStartNs.reserve(segments.size());
+
+    int offset = 0;
+    qint64 timeNs = 0;
+    for (int s = 0; s < segments.size(); ++s) {
+        const EditSegment& segment = segments[s];
+        const qint64 *t = m_sources[segment.source]->timestampData();
+
+        // The step into a segment is the recorded step into its first point; a segment
+        // that starts its source has none and borrows the step that follows instead
+        if (s > 0) {
+            const PathBuffer& source = *m_sources[segment.source];
+            qint64 stepNs = 0;
+            if (segment.firstPoint > 0) {
+                stepNs = t[segment.firstPoint] - t[segment.firstPoint - 1];
+            } else if (source.size() > 1) {
+                stepNs = t[1] - t[0];
+            }
+            timeNs += static_cast<qint64>(stepNs / segment.speed);
+        }
+
+        m_segmentOffsets.append(offset);
+        m_segmentStartNs.append(timeNs);
+        offset += segment.pointCount();
+        timeNs += static_cast<qint64>((t[segment.lastPoint] - t[segment.firstPoint]) / segment.speed);
+    }
+    m_durationNs = timeNs;
+}
+
+// 输出位置所在的片段
+int EditedPath::segmentForIndex(int index) const
+{
+    auto it = std::upper_bound(m_segmentOffsets.constBegin(), m_segmentOffsets.constEnd(), index);
+    return static_cast<int>(it - m_segmentOffsets.constBegin()) - 1;
+}
+
+QPoint EditedPath::position(int index) const
+{
+    int s = segmentForIndex(index);
+    return segmentSource(s).position(segment(s).firstPoint + index - m_segmentOffsets[s]);
+}
+
+qint64 EditedPath::timestampNs(int index) const
+{
+    int s = segmentForIndex(index);
+    return segmentTimestampNs(s, index - m_segmentOffsets[s]);
+}
+
+// 输出时间轴上不早于timestampNs的第一个点
+int EditedPath::indexAtTime(qint64 timestampNs) const
+{
+    if (isEmpty()) {
+        return 0;
+    }
+
+    auto it = std::upper_bound(m_segmentStartNs.constBegin(), m_segmentStartNs.constEnd(), timestampNs);
+    int s = qMax(0, static_cast<int>(it - m_segmentStartNs.constBegin()) - 1);
+
+    // Map back onto the source's own timeline and search its time column
+    const EditSegment& seg = segment(s);
+    const qint64 *t = segmentSource(s).timestampData();
+    qint64 sourceNs = t[seg.firstPoint] +
+                      static_cast<qint64>(qMax(qint64(0), timestampNs - m_segmentStartNs[s]) * seg.speed);
+    const qint64 *found = std::lower_bound(t + seg.firstPoint, t + seg.lastPoint + 1, sourceNs);
+    return m_segmentOffsets[s] + static_cast<int>(found - (t + seg.firstPoint));
+}
+
+int EditedPath::segmentCount() const
+{
+    return m_segmentOffsets.size();
+}
+
+const EditSegment& EditedPath::segment(int s) const
+{
+    return m_edits.segments()[s];
+}
+
+const PathBuffer& EditedPath::segmentSource(int s) const
+{
+    return *m_sources[segment(s).source];
+}
+
+int EditedPath::segmentOffset(int s) const
+{
+    return m_segmentOffsets[s];
+}
+
+qint64 EditedPath::segmentStartNs(int s) const
+{
+    return m_segmentStartNs[s];
+}
+
+qint64 EditedPath::segmentTimestampNs(int s, int offset) const
+{
+    const EditSegment& seg = segment(s);
+    const qint64 *t = segmentSource(s).timestampData();
+    return m_segmentStartNs[s] + static_cast<qint64>((t[seg.firstPoint + offset] - t[seg.firstPoint]) / seg.speed);
+}
@@ -0,0 +1,273 @@
+#include "editpathdialog.h"
+#include <QMessageBox>
+#include <utility>
+
+// 路径编辑对话框构造函数：从文件当前的编辑状态开始
+EditPathDialog::EditPathDialog(PathManager *pathManager, const QString& filename,
+                               const EditedPath& path, QWidget *parent)
+    : QDialog(parent)
+    , m_pathManager(pathManager)
+    , m_filename(filename)
+    , m_sources(path.sources())
+    , m_edits(path.editList())
+{
+    setupUI();
+    updatePreview();
+}
+
+// 设置UI界面：时间范围、编辑操作和片段列表
+void EditPathDialog::setupUI()
+{
+    setWindowTitle(QString("Edit Path - %1").arg(m_pathManager->getDisplayName(m_filename)));
+    setModal(true);
+    setFixedSize(420, 520);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    m_summaryLabel = new QLabel();
+    m_summaryLabel->setWordWrap(true);
+    mainLayout->addWidget(m_summaryLabel);
+
+    // Range and edit operations
+    QGroupBox *rangeGroup = new QGroupBox("Range");
+    QFormLayout *rangeLayout = new QFormLayout(rangeGroup);
+
+    m_fromSpinBox = new QDoubleSpinBox();
+    m_fromSpinBox->setDecimals(3);
+    m_fromSpinBox->setSuffix(" s");
+    m_fromSpinBox->setToolTip("Start of the range on the edited timeline");
+    rangeLayout->addRow("From:", m_fromSpinBox);
+
+    m_toSpinBox = new QDoubleSpinBox();
+    m_toSpinBox->setDecimals(3);
+    m_toSpinBox->setSuffix(" s");
+    m_toSpinBox->setToolTip("End of the range on the edited timeline");
+    rangeLayout->addRow("To:", m_toSpinBox);
+
+    m_trimButton = new QPushButton("Trim to Range");
+    m_trimButton->setToolTip("Keep only the points inside the range");
+    m_cutButton = new QPushButton("Cut Range");
+    m_cutButton->setToolTip("Remove the points inside the range");
+
+    QHBoxLayout *cutLayout = new QHBoxLayout();
+    cutLayout->addWidget(m_trimButton);
+    cutLayout->addWidget(m_cutButton);
+    rangeLayout->addRow("", cutLayout);
+
+    m_speedSpinBox = new QDoubleSpinBox();
+    m_speedSpinBox->setRange(EditList::MIN_SPEED, EditList::MAX_SPEED);
+    m_speedSpinBox->setSingleStep(0.1);
+    m_speedSpinBox->setValue(1.0);
+    m_speedSpinBox->setSuffix("x");
+    m_speedButton = new QPushButton("Set Speed");
+    m_speedButton->setToolTip("Play the range at this speed");
+
+    QHBoxLayout *speedLayout = new QHBoxLayout();
+    speedLayout->addWidget(m_speedSpinBox);
+    speedLayout->addWidget(m_speedButton);
+    rangeLayout->addRow("Speed:", speedLayout);
+
+    // Splice: insert another recording at the start of the range
+    m_spliceComboBox = new QComboBox();
+    for (const QString& filename : m_pathManager->getAvailablePaths()) {
+        if (filename != m_filename && !PathManager::isSessionFile(filename)) {
+            m_spliceComboBox->addItem(m_pathManager->getDisplayName(filename), filename);
+        }
+    }
+    m_spliceButton = new QPushButton("Insert");
+    m_spliceButton->setToolTip("Insert the whole selected path at the start of the range");
+    m_spliceButton->setEnabled(m_spliceComboBox->count() > 0);
+
+    QHBoxLayout *spliceLayout = new QHBoxLayout();
+    spliceLayout->addWidget(m_spliceComboBox, 1);
+    spliceLayout->addWidget(m_spliceButton);
+    rangeLayout->addRow("Splice:", spliceLayout);
+
+    // Segments of the edit list
+    QGroupBox *segmentGroup = new QGroupBox("Segments");
+    QVBoxLayout *segmentLayout = new QVBoxLayout(segmentGroup);
+    m_segmentList = new QListWidget();
+    m_segmentList->setSelectionMode(QAbstractItemView::NoSelection);
+    segmentLayout->addWidget(m_segmentList);
+
+    // Buttons
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    m_resetButton = new QPushButton("Reset");
+    m_resetButton->setToolTip("Discard all edits and play the recording as captured");
+    m_cancelButton = new QPushButton("Cancel");
+    m_saveButton = new QPushButton("Save");
+    m_saveButton->setDefault(true);
+
+    buttonLayout->addWidget(m_resetButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(m_cancelButton);
+    buttonLayout->addWidget(m_saveButton);
+
+    mainLayout->addWidget(rangeGroup);
+    mainLayout->addWidget(segmentGroup, 1);
+    mainLayout->addLayout(buttonLayout);
+
+    connect(m_trimButton, &QPushButton::clicked, this, &EditPathDialog::onTrimClicked);
+    connect(m_cutButton, &QPushButton::clicked, this, &EditPathDialog::onCutClicked);
+    connect(m_speedButton, &QPushButton::clicked, this, &EditPathDialog::onSpeedClicked);
+    connect(m_spliceButton, &QPushButton::clicked, this, &EditPathDialog::onSpliceClicked);
+    connect(m_resetButton, &QPushButton::clicked, this, &EditPathDialog::onResetClicked);
+    connect(m_saveButton, &QPushButton::clicked, this, &EditPathDialog::onSaveClicked);
+    connect(m_cancelButton, &QPushButton::clicked, this, &EditPathDialog::reject);
+}
+
+// 重建预览：更新时间范围、摘要和片段列表
+void EditPathDialog::updatePreview()
+{
+    m_preview = EditedPath(m_sources, m_edits);
+    // The timeline drops segments that no longer match their source
+    m_edits = m_preview.editList();
+
+    double durationSeconds = m_preview.durationNs() / 1e9;
+    m_fromSpinBox->setRange(0.0, durationSeconds);
+    m_toSpinBox->setRange(0.0, durationSeconds);
+    m_toSpinBox->setValue(durationSeconds);
+
+    const PathBuffer& original = *m_sources.first();
+    m_summaryLabel->setText(QString("Recorded: %1 points, %2 s\nEdited: %3 points, %4 s")
+                            .arg(original.size())
+                            .arg(QString::number(original.durationNs() / 1e9, 'f', 3))
+                            .arg(m_preview.size())
+                            .arg(QString::number(durationSeconds, 'f', 3)));
+
+    m_segmentList->clear();
+    for (int s = 0; s < m_preview.segmentCount(); ++s) {
+        const EditSegment& segment = m_preview.segment(s);
+        QString source = segment.source == 0
+                         ? QString("recording")
+                         : m_pathManager->getDisplayName(m_edits.sources()[segment.source - 1]);
+        m_segmentList->addItem(QString("%1 s: %2, points %3-%4 at %5x")
+                               .arg(QString::number(m_preview.segmentStartNs(s) / 1e9, 'f', 3))
+                               .arg(source)
+                               .arg(segment.firstPoint + 1)
+                               .arg(segment.lastPoint + 1)
+                               .arg(segment.speed));
+    }
+
+    bool hasPoints = !m_preview.isEmpty();
+    m_trimButton->setEnabled(hasPoints);
+    m_cutButton->setEnabled(hasPoints);
+    m_speedButton->setEnabled(hasPoints);
+}
+
+// 将选择的时间范围映射为输出点区间
+bool EditPathDialog::selectedRange(int& first, int& last) const
+{
+    qint64 fromNs = static_cast<qint64>(m_fromSpinBox->value() * 1e9);
+    // The spin box rounds to milliseconds, so its maximum stands for the very end
+    qint64 toNs = m_toSpinBox->value() >= m_toSpinBox->maximum()
+                  ? m_preview.durationNs()
+                  : static_cast<qint64>(m_toSpinBox->value() * 1e9);
+    if (fromNs > toNs) {
+        std::swap(fromNs, toNs);
+    }
+
+    first = m_preview.indexAtTime(fromNs);
+    last = m_preview.indexAtTime(toNs + 1) - 1;
+    return first <= last;
+}
+
+// 编辑列表是否等同于未编辑的录制
+bool EditPathDialog::isUnedited() const
+{
+    const QList<EditSegment>& segments = m_edits.segments();
+    return segments.size() == 1 &&
+           segments.first().source == 0 &&
+           segments.first().firstPoint == 0 &&
+           segments.first().lastPoint == m_sources.first()->size() - 1 &&
+           segments.first().speed == 1.0;
+}
+
+// 裁剪：只保留范围内的点
+void EditPathDialog::onTrimClicked()
+{
+    int first, last;
+    if (!selectedRange(first, last)) {
+        QMessageBox::information(this, "Trim", "The selected range contains no points.");
+        return;
+    }
+
+    m_edits.trim(first, last);
+    updatePreview();
+}
+
+// 剪切：删除范围内的点
+void EditPathDialog::onCutClicked()
+{
+    int first, last;
+    if (!selectedRange(first, last)) {
+        QMessageBox::information(this, "Cut", "The selected range contains no points.");
+        return;
+    }
+
+    if (first == 0 && last == m_preview.size() - 1) {
+        QMessageBox::information(this, "Cut", "Cutting the whole range would leave nothing to play.");
+        return;
+    }
+
+    m_edits.cut(first, last);
+    updatePreview();
+}
+
+// 变速：设置范围内的播放速度
+void EditPathDialog::onSpeedClicked()
+{
+    int first, last;
+    if (!selectedRange(first, last)) {
+        QMessageBox::information(this, "Speed", "The selected range contains no points.");
+        return;
+    }
+
+    m_edits.setSpeed(first, last, m_speedSpinBox->value());
+    updatePreview();
+}
+
+// 拼接：在范围起点插入另一条完整路径
+void EditPathDialog::onSpliceClicked()
+{
+    QString filename = m_spliceComboBox->currentData().toString();
+    if (filename.isEmpty()) {
+        return;
+    }
+
+    int source = m_edits.addSource(filename);
+    if (source >= m_sources.size()) {
+        m_sources.append(m_pathManager->loadPath(filename));
+    }
+    if (!m_sources[source]) {
+        QMessageBox::warning(this, "Splice", QString("Failed to load the selected path:\n\n%1")
+                             .arg(m_pathManager->getLastError()));
+        return;
+    }
+
+    qint64 atNs = static_cast<qint64>(qMin(m_fromSpinBox->value(), m_toSpinBox->value()) * 1e9);
+    m_edits.splice(m_preview.indexAtTime(atNs), source, 0, m_sources[source]->size() - 1);
+    updatePreview();
+}
+
+// 重置：回到未编辑的录制
+void EditPathDialog::onResetClicked()
+{
+    m_sources.resize(1);
+    m_edits = EditList::identity(m_sources.first()->size());
+    updatePreview();
+}
+
+// 保存按钮点击处理：把编辑列表追加到路径文件
+void EditPathDialog::onSaveClicked()
+{
+    // An unedited list is stored as empty so the file reads as a plain recording again
+    EditList edits = isUnedited() ? EditList() : m_edits;
+    if (!m_pathManager->saveEditList(m_filename, edits)) {
+        QMessageBox::warning(this, "Save Error", QString("Failed to save the edits:\n\n%1")
+                             .arg(m_pathManager->getLastError()));
+        return;
+    }
+
+    accept();
+}
@@ -216,6 +216,39 @@ void HotkeyManager::unregisterRecordingHotkey()
 #endif
 }
 
+// 注册飞行记录器保存热键
+bool HotkeyManager::registerFlightRecorderHotkey(const QString& keySequence)
+{
+#ifdef Q_OS_WIN
+    int modifiers, virtualKey;
+    if (!parseKeySequence(keySequence, modifiers, virtualKey)) {
+        qWarning() << "Failed to parse key sequence:" << keySequence;
+        return false;
+    }
+
+    unregisterFlightRecorderHotkey();
+
+    bool success = registerHotkey(FLIGHT_RECORDER_HOTKEY_ID, modifiers, virtualKey);
+
+    if (!success) {
+        qWarning() << "Failed to register flight recorder hotkey" << keySequence << "- may be in use by another application";
+    }
+
+    return success;
+#else
+    Q_UNUSED(keySequence)
+    return false;
+#endif
+}
+
+// 取消注册飞行记录器热键
+void HotkeyManager::unregisterFlightRecorderHotkey()
+{
+#ifdef Q_OS_WIN
+    unregisterHotkey(FLIGHT_RECORDER_HOTKEY_ID);
+#endif
+}
+
 // 解析热键序列：将Qt键位组合转换为Windows虚拟键码
 bool HotkeyManager::parseKeySequence(const QString& keySequence, int& modifiers, int& virtualKey)
 {
@@ -309,6 +342,8 @@ bool HotkeyManager::nativeEventFilter(const QByteArray &eventType, void *message
                 emit recordingHotkeyPressed();
             } else if (hotkeyId == STOP_PLAYBACK_HOTKEY_ID) {
                 emit stopPlaybackHotkeyPressed();
+            } else if (hotkeyId == FLIGHT_RECORDER_HOTKEY_ID) {
+                emit flightRecorderHotkeyPressed();
             }
 
             emit hotkeyPressed(hotkeyId);
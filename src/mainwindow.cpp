@@ -1,10 +1,13 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "editpathdialog.h"
+#include "pathcodec.h"
 #include <QApplication>
 #include <QInputDialog>
 #include <QShowEvent>
 #include <QThread>
 #include <QMessageBox>
+#include <QFutureWatcher>
 #ifdef Q_OS_WIN
 #include <windows.h>
 #endif
@@ -20,8 +23,8 @@ MainWindow::MainWindow(QWidget *parent)
     , m_hotkeyManager(new HotkeyManager(this)) // 全局热键管理器
     , m_settingsDialog(new SettingsDialog(this)) // 设置对话框
     , m_compactWindow(nullptr)  // 紧凑窗口（延迟创建）
-    , m_recordedPointsCount(0)
     , m_hotkeysRegistered(false)
+    , m_pathLoading(false)
     , m_remainingRepeats(0)
     , m_totalRepeats(1)
 {
@@ -113,6 +116,7 @@ void MainWindow::setupUI()
     QVariantMap grayOptions;
     grayOptions.insert("color", QColor(127, 140, 141));
     ui->renamePathButton->setIcon(m_awesome->icon(fa::fa_solid, fa::fa_pen_to_square, grayOptions));
+    ui->editPathButton->setIcon(m_awesome->icon(fa::fa_solid, fa::fa_scissors, grayOptions));
     ui->deletePathButton->setIcon(m_awesome->icon(fa::fa_solid, fa::fa_trash, QVariantMap{{"color", QColor(231, 76, 60)}}));
     ui->batchDeleteButton->setIcon(m_awesome->icon(fa::fa_solid, fa::fa_trash_can, QVariantMap{{"color", QColor(231, 76, 60)}}));
     ui->selectAllButton->setIcon(m_awesome->icon(fa::fa_solid, fa::fa_check_double, grayOptions));
@@ -374,8 +378,9 @@ void MainWindow::connectSignals()
     connect(ui->recordButton, &QPushButton::clicked, this, &MainWindow::onRecordButtonClicked);
     connect(m_recorder, &MouseRecorder::recordingStarted, this, &MainWindow::onRecordingStarted);
     connect(m_recorder, &MouseRecorder::recordingStopped, this, &MainWindow::onRecordingStopped);
-    connect(m_recorder, &MouseRecorder::pointRecorded, this, &MainWindow::onPointRecorded);
+    connect(m_recorder, &MouseRecorder::recordingProgress, this, &MainWindow::onRecordingProgress);
     connect(m_recorder, &MouseRecorder::recordingLimitReached, this, &MainWindow::onRecordingLimitReached);
+    connect(m_recorder, &MouseRecorder::streamingError, this, &MainWindow::onStreamingError);
 
     // Playback signals
     connect(ui->playButton, &QPushButton::clicked, this, &MainWindow::onPlayButtonClicked);
@@ -384,6 +389,7 @@ void MainWindow::connectSignals()
     connect(m_player, &MousePlayer::playbackStarted, this, &MainWindow::onPlaybackStarted);
     connect(m_player, &MousePlayer::playbackFinished, this, &MainWindow::onPlaybackFinished);
     connect(m_player, &MousePlayer::playbackStopped, this, &MainWindow::onPlaybackStopped);
+    connect(m_player, &MousePlayer::playbackProgress, this, &MainWindow::onPlaybackProgress);
 
     // Path management signals
     connect(ui->pathListWidget, &QListWidget::currentItemChanged, this, &MainWindow::onPathSelectionChanged);
@@ -393,6 +399,7 @@ void MainWindow::connectSignals()
     connect(ui->selectAllButton, &QPushButton::clicked, this, &MainWindow::onSelectAllClicked);
     connect(ui->refreshPathsButton, &QPushButton::clicked, this, &MainWindow::onRefreshPathsClicked);
     connect(ui->renamePathButton, &QPushButton::clicked, this, &MainWindow::onRenamePathClicked);
+    connect(ui->editPathButton, &QPushButton::clicked, this, &MainWindow::onEditPathClicked);
     connect(m_pathManager, &PathManager::pathSaved, this, &MainWindow::onPathSaved);
     connect(m_pathManager, &PathManager::pathDeleted, this, &MainWindow::onPathDeleted);
     connect(m_pathManager, &PathManager::pathsDeleted, this, &MainWindow::onPathsDeleted);
@@ -413,6 +420,7 @@ void MainWindow::connectSignals()
     // Hotkey signals
     connect(m_hotkeyManager, &HotkeyManager::recordingHotkeyPressed, this, &MainWindow::onRecordingHotkeyPressed);
     connect(m_hotkeyManager, &HotkeyManager::stopPlaybackHotkeyPressed, this, &MainWindow::onStopButtonClicked);
+    connect(m_hotkeyManager, &HotkeyManager::flightRecorderHotkeyPressed, this, &MainWindow::onFlightRecorderHotkeyPressed);
 
     // Settings signals
     connect(m_settingsDialog, &SettingsDialog::settingsChanged, this, &MainWindow::onSettingsChanged);
@@ -431,7 +439,6 @@ void MainWindow::onRecordButtonClicked()
 // 录制开始事件处理：更新UI状态和计数器
 void MainWindow::onRecordingStarted()
 {
-    m_recordedPointsCount = 0;
     updateRecordButtonText();
     ui->recordButton->setChecked(true);
     updateRecordingStatus("Recording...");
@@ -444,14 +451,64 @@ void MainWindow::onRecordingStopped()
     updateRecordButtonText();
     ui->recordButton->setChecked(false);
 
-    // Save the recorded path
-    QList<MousePoint> recordedPath = m_recorder->getRecordedPath();
-    qDebug() << "Recording stopped. Total points captured:" << recordedPath.size();
+    if (m_recorder->suppressedSampleCount() > 0) {
+        qDebug() << "Stationary samples skipped:" << m_recorder->suppressedSampleCount();
+    }
+
+    // Flag captures whose timing does not match the requested interval
+    CaptureStats captureStats = m_recorder->captureStats();
+    QString savedMessage = "Recording saved successfully";
+    if (captureStats.isValid()) {
+        qDebug().noquote() << captureStats.summary();
+        if (captureStats.isDegraded()) {
+            savedMessage = "Recording saved - capture quality is poor, see path details";
+        }
+    }
 
-    if (!recordedPath.isEmpty()) {
-        if (m_pathManager->savePath(recordedPath)) {
-            updateRecordingStatus(QString("Recorded %1 points. Path saved.").arg(recordedPath.size()));
-            statusBar()->showMessage("Recording saved successfully", 3000);
+    // Streaming mode: the file was written while recording and pathSaved already emitted
+    if (m_recorder->recordingWasStreamed()) {
+        int pointCount = m_recorder->recordedPointCount();
+        qDebug() << "Recording stopped. Total points streamed:" << pointCount;
+        if (pointCount > 0 && m_recorder->segmentationEnabled()) {
+            updateRecordingStatus(QString("Recorded %1 points in %2 segments. Session saved.")
+                                  .arg(pointCount).arg(m_recorder->segmentCount()));
+            statusBar()->showMessage(savedMessage, 5000);
+        } else if (pointCount > 0) {
+            updateRecordingStatus(QString("Recorded %1 points. Path saved.").arg(pointCount));
+            statusBar()->showMessage(savedMessage, 5000);
+        } else {
+            updateRecordingStatus("No movement recorded.");
+            statusBar()->showMessage("No movement to save", 3000);
+        }
+        return;
+    }
+
+    qDebug() << "Recording stopped. Total points captured:" << m_recorder->recordedPointCount()
+             << "using" << m_recorder->recordedMemoryBytes() / 1024 << "KB in memory";
+
+    // Feed the real per-sample cost back into the settings estimate
+    if (m_recorder->bytesPerSample() > 0.0) {
+        m_settingsDialog->setMeasuredBytesPerSample(m_recorder->bytesPerSample());
+    }
+
+    // In compact mode the compact window saves and replays the recording
+    if (m_compactWindow && m_compactWindow->isVisible()) {
+        return;
+    }
+
+    // Take the recording out of the recorder; the same data is saved and kept for replay
+    PathHandle recordedPath = m_recorder->takeRecordedPath();
+    m_lastRecordedPath.clear();
+    m_lastRecordedFile.clear();
+
+    if (recordedPath) {
+        QString filename = m_pathManager->generateDateBasedFilename();
+        if (m_pathManager->savePath(*recordedPath, filename, m_recorder->recordingStartTime(),
+                                    captureStats)) {
+            m_lastRecordedPath = recordedPath;
+            m_lastRecordedFile = filename;
+            updateRecordingStatus(QString("Recorded %1 points. Path saved.").arg(recordedPath->size()));
+            statusBar()->showMessage(savedMessage, 5000);
         } else {
             updateRecordingStatus("Recording failed to save!");
             statusBar()->showMessage("Failed to save recording", 3000);
@@ -463,47 +520,98 @@ void MainWindow::onRecordingStopped()
     }
 }
 
-// 录制到新点事件处理：更新点数计数和剩余百分比显示
-void MainWindow::onPointRecorded(const MousePoint& point)
+// 录制进度处理：按设置的刷新频率更新点数和剩余百分比显示
+void MainWindow::onRecordingProgress(int pointCount, const MousePoint& lastPoint, qint64 elapsedMs)
 {
-    Q_UNUSED(point)
-    m_recordedPointsCount++;
+    Q_UNUSED(lastPoint)
+    QString elapsedText = QString::number(elapsedMs / 1000.0, 'f', 1);
+
+    // Streaming mode has no point limit
+    if (m_recorder->recordingWasStreamed()) {
+        QString segmentText = m_recorder->segmentationEnabled()
+                              ? QString(", segment %1").arg(m_recorder->segmentCount())
+                              : QString();
+        updateRecordingStatus(QString("Recording... (%1 points, %2s, streaming to disk%3)")
+                              .arg(pointCount).arg(elapsedText).arg(segmentText));
+        return;
+    }
 
-    // Calculate remaining percentage
-    const int MAX_POINTS = 300000; // Same as MouseRecorder::MAX_RECORDING_POINTS
-    double usedPercentage = (double)m_recordedPointsCount / MAX_POINTS * 100.0;
-    double remainingPercentage = 100.0 - usedPercentage;
+    // Calculate remaining percentage of the memory budget
+    double usedPercentage = (double)m_recorder->recordedMemoryBytes() / m_recorder->memoryBudget() * 100.0;
+    double remainingPercentage = qMax(0.0, 100.0 - usedPercentage);
+
+    // Real cost per sample and projected time left at the current rate
+    double bytesPerSample = m_recorder->bytesPerSample();
+    qint64 remainingMs = m_recorder->projectedRemainingMs();
+    QString usageText = bytesPerSample > 0.0
+                        ? QString("%1 B/sample").arg(QString::number(bytesPerSample, 'f', 1))
+                        : QString("measuring");
+    if (remainingMs >= 0) {
+        qint64 remainingSec = remainingMs / 1000;
+        usageText += remainingSec >= 3600
+                     ? QString(", ~%1h %2m left").arg(remainingSec / 3600).arg((remainingSec / 60) % 60)
+                     : QString(", ~%1m %2s left").arg(remainingSec / 60).arg(remainingSec % 60);
+    }
 
     // Format the status message
     QString statusMsg;
     if (remainingPercentage > 10.0) {
-        statusMsg = QString("Recording... (%1 points, %2% remaining)")
-                   .arg(m_recordedPointsCount)
-                   .arg(QString::number(remainingPercentage, 'f', 1));
+        statusMsg = QString("Recording... (%1 points, %2s, %3% memory remaining, %4)")
+                   .arg(pointCount)
+                   .arg(elapsedText)
+                   .arg(QString::number(remainingPercentage, 'f', 1))
+                   .arg(usageText);
     } else if (remainingPercentage > 1.0) {
-        statusMsg = QString("Recording... (%1 points, %2% remaining)")
-                   .arg(m_recordedPointsCount)
-                   .arg(QString::number(remainingPercentage, 'f', 2));
+        statusMsg = QString("Recording... (%1 points, %2s, %3% memory remaining, %4)")
+                   .arg(pointCount)
+                   .arg(elapsedText)
+                   .arg(QString::number(remainingPercentage, 'f', 2))
+                   .arg(usageText);
     } else {
-        statusMsg = QString("Recording... (%1 points, %2% remaining - Near limit!)")
-                   .arg(m_recordedPointsCount)
+        statusMsg = QString("Recording... (%1 points, %2s, %3% memory remaining - Near limit!)")
+                   .arg(pointCount)
+                   .arg(elapsedText)
                    .arg(QString::number(remainingPercentage, 'f', 3));
     }
 
     updateRecordingStatus(statusMsg);
 }
 
+// 播放进度处理：在状态栏显示播放百分比
+void MainWindow::onPlaybackProgress(int pointsPlayed, int totalPoints, const QPoint& position)
+{
+    Q_UNUSED(position)
+    int percent = totalPoints > 0 ? pointsPlayed * 100 / totalPoints : 100;
+
+    if (m_totalRepeats > 1) {
+        int currentRepeat = m_totalRepeats - m_remainingRepeats;
+        statusBar()->showMessage(QString("Playing %1/%2... %3% (Press ESC to stop)").arg(currentRepeat).arg(m_totalRepeats).arg(percent));
+    } else {
+        statusBar()->showMessage(QString("Playing back mouse path... %1% (Press ESC to stop)").arg(percent));
+    }
+}
+
 // 录制达到限制处理：显示警告信息
 void MainWindow::onRecordingLimitReached()
 {
-    updateRecordingStatus("Recording stopped: Maximum points limit reached (300,000 points)");
+    QString budgetText = QString("%1 MB").arg(m_recorder->memoryBudget() / (1024 * 1024));
+    updateRecordingStatus(QString("Recording stopped: Memory budget reached (%1)").arg(budgetText));
     statusBar()->showMessage("Recording automatically stopped due to memory limit", 5000);
 
     // Show warning message box
     QMessageBox::warning(this, "Recording Limit Reached",
-                        "Recording has been automatically stopped because it reached the maximum limit of 300,000 points.\n\n"
-                        "This limit prevents excessive memory usage during long recordings.\n"
-                        "The recorded path has been saved successfully.");
+                        QString("Recording has been automatically stopped because it reached the memory budget of %1.\n\n"
+                                "Increase the budget or enable Stream to Disk in Settings for longer recordings.\n"
+                                "The recorded path has been saved successfully.").arg(budgetText));
+}
+
+// 流式保存出错处理：提示用户已写入的数据仍然有效
+void MainWindow::onStreamingError(const QString& message)
+{
+    statusBar()->showMessage("Streaming to disk failed", 5000);
+    QMessageBox::warning(this, "Streaming Error",
+                        QString("Recording could not be streamed to disk:\n\n%1\n\n"
+                                "Points written before the error are kept in the saved file.").arg(message));
 }
 
 // 播放按钮点击处理：加载并播放选中的鼠标路径
@@ -514,16 +622,26 @@ void MainWindow::onPlayButtonClicked()
         return;
     }
 
-    QList<MousePoint> path = m_pathManager->loadPath(m_currentSelectedPath);
-    if (path.isEmpty()) {
-        QString errorMsg = m_pathManager->getLastError();
-        if (errorMsg.isEmpty()) {
-            errorMsg = "Unknown error occurred while loading the path.";
+    loadSelectedPathAsync([this](const PathLoadResult& result) {
+        // Recording or playback may have been started from a hotkey while the file loaded
+        if (m_recorder->isRecording() || m_player->isPlaying()) {
+            return;
         }
-        QMessageBox::warning(this, "Load Error", QString("Failed to load the selected path:\n\n%1").arg(errorMsg));
-        return;
-    }
 
+        // Damaged chunks or missing splice sources: play what loaded, but say so first
+        if (!result.error.isEmpty()) {
+            QMessageBox::warning(this, "Path Partially Loaded",
+                                 QString("Some of the selected path could not be loaded:\n\n%1\n\n"
+                                         "Playback will use the points that were recovered.").arg(result.error));
+        }
+
+        startPlayback(result.path);
+    });
+}
+
+// 开始播放已加载的路径
+void MainWindow::startPlayback(const EditedPath& path)
+{
     // 初始化重复播放状态
     m_currentPlaybackPath = path;
     m_totalRepeats = m_repeatSpinBox->value();
@@ -581,7 +699,7 @@ void MainWindow::onPlaybackFinished()
         m_hotkeyManager->unregisterStopPlaybackHotkey();
 
         // 清空播放路径
-        m_currentPlaybackPath.clear();
+        m_currentPlaybackPath = EditedPath();
     }
 }
 
@@ -603,7 +721,7 @@ void MainWindow::onPlaybackStopped()
     m_hotkeyManager->unregisterStopPlaybackHotkey();
 
     // 清空播放路径和重置重复次数
-    m_currentPlaybackPath.clear();
+    m_currentPlaybackPath = EditedPath();
     m_remainingRepeats = 0;
 }
 
@@ -623,12 +741,14 @@ void MainWindow::onPathSelectionChanged()
         m_currentSelectedPath = currentItem->data(Qt::UserRole).toString();
         ui->deletePathButton->setEnabled(true);
         ui->renamePathButton->setEnabled(true);
+        ui->editPathButton->setEnabled(true);
         ui->playButton->setEnabled(true);
         updatePathDetails();
     } else {
         m_currentSelectedPath.clear();
         ui->deletePathButton->setEnabled(false);
         ui->renamePathButton->setEnabled(false);
+        ui->editPathButton->setEnabled(false);
         ui->playButton->setEnabled(false);
         ui->pathDetailsTextEdit->clear();
     }
@@ -699,6 +819,65 @@ void MainWindow::onRenamePathClicked()
     }
 }
 
+// 编辑路径按钮点击处理：打开编辑对话框，编辑以编辑列表形式保存
+void MainWindow::onEditPathClicked()
+{
+    if (m_currentSelectedPath.isEmpty()) {
+        return;
+    }
+
+    if (PathManager::isSessionFile(m_currentSelectedPath)) {
+        QMessageBox::information(this, "Edit Path", "Sessions cannot be edited. Edit one of their segments instead.");
+        return;
+    }
+
+    QString filename = m_currentSelectedPath;
+    loadSelectedPathAsync([this, filename](const PathLoadResult& result) {
+        EditPathDialog dialog(m_pathManager, filename, result.path, this);
+        if (dialog.exec() == QDialog::Accepted) {
+            updatePathDetails();
+            statusBar()->showMessage("Edits saved", 3000);
+        }
+    });
+}
+
+// 异步加载选中的路径：文件在后台线程读取和解码，界面保持响应，完成后调用onLoaded
+void MainWindow::loadSelectedPathAsync(const std::function<void(const PathLoadResult&)>& onLoaded)
+{
+    if (m_pathLoading) {
+        return;
+    }
+
+    // A recording saved by this window is replayed from memory instead of re-reading the file
+    PathHandle preloaded = m_currentSelectedPath == m_lastRecordedFile ? m_lastRecordedPath : PathHandle();
+
+    m_pathLoading = true;
+    ui->playButton->setEnabled(false);
+    statusBar()->showMessage("Loading path...");
+
+    QFutureWatcher<PathLoadResult> *watcher = new QFutureWatcher<PathLoadResult>(this);
+    connect(watcher, &QFutureWatcher<PathLoadResult>::finished, this, [this, watcher, onLoaded]() {
+        watcher->deleteLater();
+        m_pathLoading = false;
+        statusBar()->clearMessage();
+        ui->playButton->setEnabled(!m_recorder->isRecording() && !m_player->isPlaying() &&
+                                   !m_currentSelectedPath.isEmpty());
+
+        PathLoadResult result = watcher->result();
+        if (result.path.isNull()) {
+            QString errorMsg = result.error;
+            if (errorMsg.isEmpty()) {
+                errorMsg = "Unknown error occurred while loading the path.";
+            }
+            QMessageBox::warning(this, "Load Error", QString("Failed to load the selected path:\n\n%1").arg(errorMsg));
+            return;
+        }
+
+        onLoaded(result);
+    });
+    watcher->setFuture(m_pathManager->loadEditedPathAsync(m_currentSelectedPath, preloaded));
+}
+
 void MainWindow::onPathSaved(const QString& filename)
 {
     updatePathList();
@@ -715,7 +894,10 @@ void MainWindow::onPathSaved(const QString& filename)
 
 void MainWindow::onPathDeleted(const QString& filename)
 {
-    Q_UNUSED(filename)
+    if (filename == m_lastRecordedFile) {
+        m_lastRecordedPath.clear();
+        m_lastRecordedFile.clear();
+    }
     updatePathList();
 }
 
@@ -753,13 +935,18 @@ void MainWindow::onSelectAllClicked()
 
 void MainWindow::onPathsDeleted(const QStringList& filenames)
 {
-    Q_UNUSED(filenames)
+    if (filenames.contains(m_lastRecordedFile)) {
+        m_lastRecordedPath.clear();
+        m_lastRecordedFile.clear();
+    }
     updatePathList();
 }
 
 void MainWindow::onPathRenamed(const QString& oldFilename, const QString& newFilename)
 {
-    Q_UNUSED(oldFilename);
+    if (oldFilename == m_lastRecordedFile) {
+        m_lastRecordedFile = newFilename;
+    }
     updatePathList();
 
     // Select the renamed path
@@ -851,21 +1038,53 @@ void MainWindow::onActionDiagnostics()
     // Current settings
     diagnostics += QString("\n=== Current Settings ===\n");
     diagnostics += QString("Recording Interval: %1ms\n").arg(m_settingsDialog->getRecordingInterval());
+    diagnostics += QString("Skip Stationary Samples: %1\n").arg(m_settingsDialog->getSuppressStationary() ? "Yes" : "No");
+    diagnostics += QString("Adaptive Rate: %1\n").arg(!m_recorder->adaptiveRate() ? QString("Off")
+        : m_recorder->velocityBoost() ? QString("On (idle %1ms, fast stroke boost)").arg(CaptureThread::IDLE_INTERVAL_MS)
+                                      : QString("On (idle %1ms)").arg(CaptureThread::IDLE_INTERVAL_MS));
+    diagnostics += QString("Flight Recorder: %1\n").arg(m_recorder->isFlightRecorderActive()
+        ? QString("On (%1s pre-roll, %2)").arg(m_recorder->flightRecorderSeconds()).arg(m_settingsDialog->getFlightRecorderHotkey())
+        : QString("Off"));
+    diagnostics += QString("Memory Budget: %1 MB (%2)\n")
+                   .arg(m_recorder->memoryBudget() / (1024 * 1024))
+                   .arg(m_settingsDialog->getMeasuredBytesPerSample() > 0.0
+                        ? QString("%1 B/sample measured").arg(QString::number(m_settingsDialog->getMeasuredBytesPerSample(), 'f', 1))
+                        : QString("not measured yet"));
+    diagnostics += QString("Stream to Disk: %1\n").arg(m_settingsDialog->getStreamToDisk() ? "Yes" : "No");
+    diagnostics += QString("File Codec: %1\n").arg(PathCodec::name(m_pathManager->pathCodec()));
+    if (m_recorder->segmentationEnabled()) {
+        diagnostics += QString("Segment Limits: %1 MB / %2 points / %3 min (0 = no limit)\n")
+                       .arg(m_settingsDialog->getSegmentMaxBytes() / (1024 * 1024))
+                       .arg(m_settingsDialog->getSegmentMaxPoints())
+                       .arg(m_settingsDialog->getSegmentMaxDurationMs() / 60000);
+    }
+    diagnostics += QString("Capture Mode: %1\n").arg(m_recorder->captureMode() == MouseRecorder::EventCapture
+                                                      ? "Pointer events" : "Timer polling");
     diagnostics += QString("Playback Speed: %1x\n").arg(m_settingsDialog->getDefaultPlaybackSpeed());
 
+    // Last calibration run on this machine
+    diagnostics += QString("\n=== Capture Calibration ===\n");
+    diagnostics += m_settingsDialog->getLastCalibration().summary() + "\n";
+
     // Recent path information
     if (!m_currentSelectedPath.isEmpty()) {
         diagnostics += QString("\n=== Selected Path Info ===\n");
         diagnostics += QString("File: %1\n").arg(m_currentSelectedPath);
 
-        QList<MousePoint> path = m_pathManager->loadPath(m_currentSelectedPath);
-        if (!path.isEmpty()) {
-            diagnostics += QString("Points: %1\n").arg(path.size());
-            diagnostics += QString("First Point: (%1, %2)\n").arg(path.first().position().x()).arg(path.first().position().y());
-            diagnostics += QString("Last Point: (%1, %2)\n").arg(path.last().position().x()).arg(path.last().position().y());
-
-            qint64 duration = path.last().timestamp().toMSecsSinceEpoch() - path.first().timestamp().toMSecsSinceEpoch();
-            diagnostics += QString("Duration: %1ms\n").arg(duration);
+        // Only the header summary is shown; older files would have to be read in full,
+        // which does not belong on the GUI thread
+        PathSummary summary = m_pathManager->getPathSummary(m_currentSelectedPath);
+        if (!summary.isValid()) {
+            diagnostics += "Point statistics: not stored in this file format\n";
+        } else {
+            diagnostics += QString("Points: %1\n").arg(summary.pointCount);
+            diagnostics += QString("First Point: (%1, %2)\n").arg(summary.firstPoint.x()).arg(summary.firstPoint.y());
+            diagnostics += QString("Last Point: (%1, %2)\n").arg(summary.lastPoint.x()).arg(summary.lastPoint.y());
+            diagnostics += QString("Bounds: (%1, %2) - (%3, %4)\n")
+                           .arg(summary.bounds.left()).arg(summary.bounds.top())
+                           .arg(summary.bounds.right()).arg(summary.bounds.bottom());
+            diagnostics += QString("Duration: %1ms\n").arg(summary.durationNs / 1000000);
+            diagnostics += QString("Average Rate: %1 Hz\n").arg(QString::number(summary.averageRateHz(), 'f', 1));
         }
     }
 
@@ -1007,6 +1226,21 @@ void MainWindow::onRecordingHotkeyPressed()
     }
 }
 
+// 飞行记录器热键处理：保存预录内容并继续录制，录制中再次按下则停止
+void MainWindow::onFlightRecorderHotkeyPressed()
+{
+    if (m_player->isPlaying()) {
+        return;
+    }
+
+    if (m_recorder->isRecording()) {
+        m_recorder->stopRecording();
+    } else if (m_recorder->saveFlightRecording()) {
+        statusBar()->showMessage(QString("Saved last %1s of motion, recording continues...")
+                                 .arg(m_recorder->flightRecorderSeconds()), 3000);
+    }
+}
+
 // 设置改变处理：应用新设置到所有组件
 void MainWindow::onSettingsChanged()
 {
@@ -1019,7 +1253,39 @@ void MainWindow::loadSettings()
 {
     // Apply recording interval
     int interval = m_settingsDialog->getRecordingInterval();
+    MouseRecorder::CaptureMode captureMode = static_cast<MouseRecorder::CaptureMode>(m_settingsDialog->getCaptureMode());
+    // Only these change the pre-roll ring; other settings keep the samples already captured
+    // (a velocity boost change re-arms the flight recorder on its own)
+    int preRollSeconds = qBound(1, m_settingsDialog->getFlightRecorderSeconds(), int(MouseRecorder::MAX_PRE_ROLL_SECONDS));
+    bool flightRecorderChanged = !m_recorder->isFlightRecorderActive() ||
+                                 m_recorder->flightRecorderSeconds() != preRollSeconds ||
+                                 m_recorder->recordingInterval() != interval ||
+                                 m_recorder->captureMode() != captureMode;
     m_recorder->setRecordingInterval(interval);
+    m_recorder->setCaptureMode(captureMode);
+    m_recorder->setStreamingTarget(m_settingsDialog->getStreamToDisk() ? m_pathManager : nullptr);
+    m_recorder->setSegmentLimits(m_settingsDialog->getSegmentMaxBytes(),
+                                 m_settingsDialog->getSegmentMaxPoints(),
+                                 m_settingsDialog->getSegmentMaxDurationMs());
+    m_pathManager->setPathCodec(static_cast<quint8>(m_settingsDialog->getPathCodec()));
+    m_recorder->setMemoryBudget(m_settingsDialog->getMemoryBudget());
+    m_recorder->setSuppressStationary(m_settingsDialog->getSuppressStationary());
+    m_recorder->setAdaptiveRate(m_settingsDialog->getAdaptiveRate());
+    m_recorder->setVelocityBoost(m_settingsDialog->getAdaptiveRate() && m_settingsDialog->getVelocityBoost());
+
+    // Flight recorder ring is sized from the interval and capture mode applied above
+    if (m_settingsDialog->getFlightRecorderEnabled()) {
+        if (flightRecorderChanged) {
+            m_recorder->startFlightRecorder(preRollSeconds);
+        }
+    } else {
+        m_recorder->stopFlightRecorder();
+    }
+
+    // Apply UI refresh rate for progress notifications
+    int progressRate = m_settingsDialog->getProgressRate();
+    m_recorder->setProgressRate(progressRate);
+    m_player->setProgressRate(progressRate);
 
     // Apply default playback speed
     double speed = m_settingsDialog->getDefaultPlaybackSpeed();
@@ -1063,6 +1329,8 @@ void MainWindow::applySettings()
                 m_hotkeysRegistered = false;
             }
         }
+
+        updateFlightRecorderHotkey();
     }
 }
 
@@ -1082,6 +1350,12 @@ void MainWindow::updateIntervalDisplay()
         displayText = QString("Recording Interval: %1ms (Low precision)").arg(interval);
     }
 
+    if (m_recorder->captureMode() == MouseRecorder::EventCapture) {
+        displayText = "Recording: Pointer events (one point per motion)";
+    } else if (m_recorder->adaptiveRate()) {
+        displayText += " - adaptive";
+    }
+
     ui->intervalLabel->setText(displayText);
 }
 
@@ -1124,4 +1398,21 @@ void MainWindow::registerHotkeysWhenReady()
         statusBar()->showMessage(QString("Global hotkey %1 registered successfully").arg(configuredHotkey), 3000);
         m_hotkeysRegistered = true;
     }
+
+    updateFlightRecorderHotkey();
+}
+
+// 根据设置注册或取消飞行记录器热键
+void MainWindow::updateFlightRecorderHotkey()
+{
+    m_hotkeyManager->unregisterFlightRecorderHotkey();
+
+    if (!m_settingsDialog->getFlightRecorderEnabled()) {
+        return;
+    }
+
+    QString flightHotkey = m_settingsDialog->getFlightRecorderHotkey();
+    if (!m_hotkeyManager->registerFlightRecorderHotkey(flightHotkey)) {
+        qWarning() << "Failed to register flight recorder hotkey" << flightHotkey;
+    }
 }
@@ -1,8 +1,8 @@
 #include "mouseplayer.h"
-#include <QDateTime>
 #include <QDebug>
 #ifdef Q_OS_WIN
 #include <windows.h>
+#include <mmsystem.h>
 #endif
 
 // 鼠标播放器构造函数：初始化定时器和播放参数
@@ -10,43 +10,50 @@ MousePlayer::MousePlayer(QObject *parent)
     : QObject(parent)
     , m_playbackTimer(new QTimer(this))
     , m_currentIndex(0)
+    , m_segment(0)
+    , m_segmentPoint(0)
     , m_isPlaying(false)
     , m_playbackSpeed(1.0)  // 默认原始速度
-    , m_startTime(0)
+    , m_clockBaseNs(0)
+    , m_timerResolutionRaised(false)
+    , m_progressIntervalMs(1000 / 30)
 {
     connect(m_playbackTimer, &QTimer::timeout, this, &MousePlayer::playNextPoint);
     m_playbackTimer->setSingleShot(true);
+    m_playbackTimer->setTimerType(Qt::PreciseTimer);
 }
 
-// 播放鼠标路径：按照时间间隔重放鼠标移动
-void MousePlayer::playPath(const QList<MousePoint>& path)
+// 播放鼠标路径：按照录制时间轴重放鼠标移动
+void MousePlayer::playPath(const PathHandle& path)
 {
-    if (m_isPlaying || path.isEmpty()) {
+    playPath(EditedPath(path));
+}
+
+// 播放编辑后的路径：直接从源路径按编辑列表取点
+void MousePlayer::playPath(const EditedPath& path)
+{
+    if (m_isPlaying || path.isNull() || path.isEmpty()) {
         return;
     }
 
     m_playbackPath = path;
     m_currentIndex = 0;
+    m_segment = 0;
+    m_segmentPoint = 0;
     m_isPlaying = true;
-    m_startTime = QDateTime::currentMSecsSinceEpoch();
+    m_lastProgress.invalidate();
+
+#ifdef Q_OS_WIN
+    // Millisecond timer resolution for the duration of playback, as in the capture thread
+    m_timerResolutionRaised = timeBeginPeriod(1) == TIMERR_NOERROR;
+#endif
 
     emit playbackStarted();
 
-    // Move to first position immediately
-    moveMouseTo(m_playbackPath.first().position());
-    emit positionChanged(m_playbackPath.first().position());
-
-    if (m_playbackPath.size() > 1) {
-        m_currentIndex = 1;
-        // Calculate delay to next point
-        qint64 delay = (m_playbackPath[1].timestamp().toMSecsSinceEpoch() -
-                       m_playbackPath[0].timestamp().toMSecsSinceEpoch()) / m_playbackSpeed;
-        m_playbackTimer->start(qMax(1LL, delay));
-    } else {
-        // Only one point, finish immediately
-        m_isPlaying = false;
-        emit playbackFinished();
-    }
+    // The first point is played immediately and defines the start of the timeline
+    m_clockBaseNs = 0;
+    m_clock.start();
+    playNextPoint();
 }
 
 // 停止播放：终止定时器并重置状态
@@ -59,6 +66,7 @@ void MousePlayer::stopPlaying()
     m_playbackTimer->stop();
     m_isPlaying = false;
     m_currentIndex = 0;
+    finishPlayback();
 
     emit playbackStopped();
 }
@@ -69,9 +77,13 @@ bool MousePlayer::isPlaying() const
     return m_isPlaying;
 }
 
-// 设置播放速度：调整时间间隔来改变播放速度
+// 设置播放速度：调整时间轴的推进速率，播放中修改时从当前位置开始生效
 void MousePlayer::setPlaybackSpeed(double speed)
 {
+    if (m_isPlaying) {
+        m_clockBaseNs = playbackOffsetNs();
+        m_clock.restart();
+    }
     m_playbackSpeed = qMax(0.1, speed); // Minimum speed of 0.1x
 }
 
@@ -81,41 +93,103 @@ double MousePlayer::playbackSpeed() const
     return m_playbackSpeed;
 }
 
-// 播放下一个点：移动鼠标并计算下一次延迟
+// 设置进度通知频率（每秒次数）
+void MousePlayer::setProgressRate(int hz)
+{
+    m_progressIntervalMs = 1000 / qBound(1, hz, 1000);
+}
+
+// 获取进度通知频率
+int MousePlayer::progressRate() const
+{
+    return 1000 / m_progressIntervalMs;
+}
+
+// 报告播放位置：逐点信号 + 按频率合并的进度信号
+void MousePlayer::reportPosition(const QPoint& position)
+{
+    emit positionChanged(position);
+
+    int pointsPlayed = qMax(1, m_currentIndex);
+    bool isLast = pointsPlayed >= m_playbackPath.size();
+    if (isLast || !m_lastProgress.isValid() || m_lastProgress.elapsed() >= m_progressIntervalMs) {
+        m_lastProgress.start();
+        emit playbackProgress(pointsPlayed, m_playbackPath.size(), position);
+    }
+}
+
+// 当前播放位置在录制时间轴上的偏移（纳秒）
+qint64 MousePlayer::playbackOffsetNs() const
+{
+    return m_clockBaseNs + static_cast<qint64>(m_clock.nsecsElapsed() * m_playbackSpeed);
+}
+
+// 播放所有已到期的点，然后为下一个点安排定时器
 void MousePlayer::playNextPoint()
 {
-    if (!m_isPlaying || m_currentIndex >= m_playbackPath.size()) {
-        m_isPlaying = false;
-        emit playbackFinished();
+    if (!m_isPlaying) {
         return;
     }
 
-    // Move mouse to current position
-    const MousePoint& currentPoint = m_playbackPath[m_currentIndex];
-    moveMouseTo(currentPoint.position());
-    emit positionChanged(currentPoint.position());
-
-    m_currentIndex++;
+    qint64 nowNs = playbackOffsetNs();
 
-    // Schedule next point if available
-    if (m_currentIndex < m_playbackPath.size()) {
-        qint64 originalDelay = (m_playbackPath[m_currentIndex].timestamp().toMSecsSinceEpoch() -
-                               currentPoint.timestamp().toMSecsSinceEpoch());
-        qint64 adjustedDelay = originalDelay / m_playbackSpeed;
-        qint64 finalDelay = qMax(1LL, adjustedDelay);
+    // If the GUI thread was held up, every point that is already due is played now
+    // so playback catches up instead of drifting later for the rest of the path
+    while (m_segment < m_playbackPath.segmentCount()) {
+        const EditSegment& segment = m_playbackPath.segment(m_segment);
+        if (m_segmentPoint >= segment.pointCount()) {
+            m_segment++;
+            m_segmentPoint = 0;
+            continue;
+        }
+        if (m_playbackPath.segmentTimestampNs(m_segment, m_segmentPoint) > nowNs) {
+            break;
+        }
 
-        // qDebug() << "Scheduling next point" << m_currentIndex
-        //          << "Original delay:" << originalDelay << "ms"
-        //          << "Adjusted delay:" << adjustedDelay << "ms"
-        //          << "Final delay:" << finalDelay << "ms"
-        //          << "Speed:" << m_playbackSpeed;
+        QPoint position = m_playbackPath.segmentSource(m_segment).position(segment.firstPoint + m_segmentPoint);
+        moveMouseTo(position);
+        m_segmentPoint++;
+        m_currentIndex++;
+        reportPosition(position);
+    }
 
-        m_playbackTimer->start(finalDelay);
-    } else {
+    if (m_currentIndex >= m_playbackPath.size()) {
         // Finished playing all points
         m_isPlaying = false;
+        finishPlayback();
         emit playbackFinished();
+        return;
     }
+
+    scheduleNextPoint();
+}
+
+// 按下一个点的绝对截止时间安排定时器
+void MousePlayer::scheduleNextPoint()
+{
+    qint64 deadlineNs = m_playbackPath.segmentTimestampNs(m_segment, m_segmentPoint);
+    // Lead time in wall-clock ns, undoing the speed scaling of the timeline
+    qint64 leadNs = static_cast<qint64>((deadlineNs - playbackOffsetNs()) / m_playbackSpeed);
+
+    // Round up so the timer never fires before the deadline; a point that falls due
+    // between ticks is played by the catch-up loop on the next tick rather than by
+    // polling the event loop, so the GUI thread is never kept busy waiting
+    qint64 delayMs = (qMax<qint64>(leadNs, 0) + 999999) / 1000000;
+    m_playbackTimer->start(static_cast<int>(qMax<qint64>(delayMs, 1)));
+}
+
+// 播放结束：释放路径句柄并恢复系统计时器精度
+void MousePlayer::finishPlayback()
+{
+    // Repeats are started by the caller with its own handle
+    m_playbackPath = EditedPath();
+
+#ifdef Q_OS_WIN
+    if (m_timerResolutionRaised) {
+        timeEndPeriod(1);
+    }
+#endif
+    m_timerResolutionRaised = false;
 }
 
 // 移动鼠标到指定位置：使用Windows API实现高精度移动
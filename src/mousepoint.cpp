@@ -1,27 +1,17 @@
 #include "mousepoint.h"
 
 MousePoint::MousePoint()
-    : m_position(0, 0), m_timestamp(QDateTime::currentDateTime()), m_deltaMs(0), m_useRelativeTime(false)
+    : m_position(0, 0), m_timestampNs(0)
 {
 }
 
-MousePoint::MousePoint(const QPoint& position, const QDateTime& timestamp)
-    : m_position(position), m_timestamp(timestamp), m_deltaMs(0), m_useRelativeTime(false)
+MousePoint::MousePoint(const QPoint& position, qint64 timestampNs)
+    : m_position(position), m_timestampNs(timestampNs)
 {
 }
 
-MousePoint::MousePoint(int x, int y, const QDateTime& timestamp)
-    : m_position(x, y), m_timestamp(timestamp), m_deltaMs(0), m_useRelativeTime(false)
-{
-}
-
-MousePoint::MousePoint(const QPoint& position, quint32 deltaMs)
-    : m_position(position), m_timestamp(), m_deltaMs(deltaMs), m_useRelativeTime(true)
-{
-}
-
-MousePoint::MousePoint(int x, int y, quint32 deltaMs)
-    : m_position(x, y), m_timestamp(), m_deltaMs(deltaMs), m_useRelativeTime(true)
+MousePoint::MousePoint(int x, int y, qint64 timestampNs)
+    : m_position(x, y), m_timestampNs(timestampNs)
 {
 }
 
@@ -30,24 +20,19 @@ QPoint MousePoint::position() const
     return m_position;
 }
 
-QDateTime MousePoint::timestamp() const
-{
-    return m_timestamp;
-}
-
-qint64 MousePoint::delay() const
+qint64 MousePoint::timestampNs() const
 {
-    return m_timestamp.toMSecsSinceEpoch();
+    return m_timestampNs;
 }
 
-quint32 MousePoint::deltaMs() const
+qint64 MousePoint::timestampUs() const
 {
-    return m_deltaMs;
+    return m_timestampNs / 1000;
 }
 
-bool MousePoint::isRelativeTime() const
+qint64 MousePoint::timestampMs() const
 {
-    return m_useRelativeTime;
+    return m_timestampNs / 1000000;
 }
 
 void MousePoint::setPosition(const QPoint& position)
@@ -55,38 +40,7 @@ void MousePoint::setPosition(const QPoint& position)
     m_position = position;
 }
 
-void MousePoint::setTimestamp(const QDateTime& timestamp)
+void MousePoint::setTimestampNs(qint64 timestampNs)
 {
-    m_timestamp = timestamp;
-    m_useRelativeTime = false;
+    m_timestampNs = timestampNs;
 }
-
-void MousePoint::setDeltaMs(quint32 deltaMs)
-{
-    m_deltaMs = deltaMs;
-    m_useRelativeTime = true;
-}
-
-QDataStream& operator<<(QDataStream& out, const MousePoint& point)
-{
-    out << point.m_position << point.m_useRelativeTime;
-    if (point.m_useRelativeTime) {
-        out << point.m_deltaMs;
-    } else {
-        out << point.m_timestamp;
-    }
-    return out;
-}
-
-QDataStream& operator>>(QDataStream& in, MousePoint& point)
-{
-    in >> point.m_position >> point.m_useRelativeTime;
-    if (point.m_useRelativeTime) {
-        in >> point.m_deltaMs;
-        point.m_timestamp = QDateTime();
-    } else {
-        in >> point.m_timestamp;
-        point.m_deltaMs = 0;
-    }
-    return in;
-}
\ No newline at end of file
@@ -1,45 +1,90 @@
 #include "mouserecorder.h"
-#include <QDateTime>
+#include "pointereventsource.h"
+#include "pathmanager.h"
+#include "pathstreamwriter.h"
 #include <QDebug>
+#include <QFileInfo>
 #include <QThread>
 #include <QCoreApplication>
-#ifdef Q_OS_WIN
-#include <windows.h>
-#endif
 
-// 鼠标录制器构造函数：初始化定时器和录制参数
+// 鼠标录制器构造函数：初始化采集线程、样本队列和录制参数
 MouseRecorder::MouseRecorder(QObject *parent)
     : QObject(parent)
-    , m_recordingTimer(new QTimer(this))
+    , m_drainTimer(new QTimer(this))
+    , m_sampleQueue(SAMPLE_QUEUE_CAPACITY)
+    , m_captureThread(new CaptureThread(&m_sampleQueue, this))
+    , m_eventSource(nullptr)
+    , m_captureMode(PollingCapture)
+    , m_eventCaptureActive(false)
+    , m_limitReached(false)
+    , m_streamFailed(false)
+    , m_totalPointCount(0)
+    , m_suppressStationary(false)
+    , m_hasPendingHold(false)
+    , m_suppressedCount(0)
+    , m_flightRecorderActive(false)
+    , m_flightRecorderArmed(false)
+    , m_flightRecorderSeconds(0)
+    , m_preRollHead(0)
+    , m_preRollCount(0)
+    , m_streamingTarget(nullptr)
+    , m_streamWriter(nullptr)
+    , m_recordingWasStreamed(false)
+    , m_segmentMaxBytes(0)
+    , m_segmentMaxPoints(0)
+    , m_segmentMaxDurationMs(0)
+    , m_segmentIndex(0)
+    , m_progressIntervalMs(1000 / 30)
+    , m_sessionStartNs(0)
     , m_isRecording(false)
     , m_recordingInterval(50) // 50ms间隔，保证平滑录制
+    , m_memoryBudget(DEFAULT_MEMORY_BUDGET)
 {
-    connect(m_recordingTimer, &QTimer::timeout, this, &MouseRecorder::recordCurrentPosition, Qt::DirectConnection);
+    // Sampling happens on m_captureThread; the GUI thread only drains the queue,
+    // so UI stalls delay when points are appended but never when they are taken
+    connect(m_drainTimer, &QTimer::timeout, this, &MouseRecorder::drainCapturedSamples);
+    m_drainTimer->setInterval(DRAIN_INTERVAL_MS);
 
-    // Set timer type before setting interval
-    m_recordingTimer->setTimerType(Qt::PreciseTimer);
-    m_recordingTimer->setInterval(m_recordingInterval);
+    m_captureThread->setInterval(m_recordingInterval);
 }
 
-// 开始录制：清空录制缓存并启动定时器
+// 析构：先停止生产者线程，它们写入的队列是本对象的成员
+MouseRecorder::~MouseRecorder()
+{
+    stopProducers();
+}
+
+// 开始录制：清空录制缓存并启动采集线程或事件源
 void MouseRecorder::startRecording()
 {
     if (m_isRecording) {
         return;
     }
 
-    m_recordedPath.clear();
-    m_isRecording = true;
+    // A manual recording starts fresh; the flight recorder ring is re-armed at stop
+    if (m_flightRecorderArmed) {
+        m_drainTimer->stop();
+        stopProducers();
+        m_flightRecorderArmed = false;
+    }
+
+    resetRecordingState();
 
-    // Stop timer first to ensure clean state
-    m_recordingTimer->stop();
+    // The only wall-clock read of the session; everything else is monotonic
+    m_recordingStartTime = QDateTime::currentDateTime();
+    m_sessionStartNs = CaptureThread::monotonicNowNs();
 
-    // Set timer properties
-    m_recordingTimer->setTimerType(Qt::PreciseTimer);
-    m_recordingTimer->setInterval(m_recordingInterval);
+    openStreamingTarget();
+
+    // Event-driven capture: record the starting position, then one point per motion event
+    bool eventCapture = startProducers();
+    if (eventCapture) {
+        appendPoint(MousePoint(CaptureThread::cursorPosition(), 0));
+    }
+    m_statsCollector.reset(eventCapture ? 0 : m_recordingInterval * 1000000LL,
+                           !eventCapture && m_captureThread->isAdaptive());
 
-    // Start the timer
-    m_recordingTimer->start();
+    m_lastProgress.start();
 
     // Force event processing
     QCoreApplication::processEvents();
@@ -47,17 +92,164 @@ void MouseRecorder::startRecording()
     emit recordingStarted();
 }
 
-// 停止录制：停止定时器并发出停止信号
+// 保存飞行记录：以环形缓冲中的预录样本开始一次正常录制，之后的样本继续追加
+bool MouseRecorder::saveFlightRecording()
+{
+    if (m_isRecording || !m_flightRecorderArmed) {
+        return false;
+    }
+
+    // Producers keep running; take everything captured so far into the ring
+    drainIntoPreRoll();
+    m_flightRecorderArmed = false;
+
+    resetRecordingState();
+
+    // Keep only the pre-roll window; the ring may hold older samples in event mode
+    qint64 nowNs = CaptureThread::monotonicNowNs();
+    qint64 windowStartNs = nowNs - m_flightRecorderSeconds * 1000000000LL;
+    int first = (m_preRollHead - m_preRollCount + m_preRoll.size()) % m_preRoll.size();
+    int skipped = 0;
+    while (skipped < m_preRollCount && m_preRoll[(first + skipped) % m_preRoll.size()].timestampNs < windowStartNs) {
+        ++skipped;
+    }
+    first = (first + skipped) % m_preRoll.size();
+    int count = m_preRollCount - skipped;
+
+    // The session starts at the oldest pre-roll sample, so its offsets begin at 0
+    m_sessionStartNs = count > 0 ? m_preRoll[first].timestampNs : nowNs;
+    m_recordingStartTime = QDateTime::currentDateTime().addMSecs(-(nowNs - m_sessionStartNs) / 1000000);
+
+    openStreamingTarget();
+
+    m_statsCollector.reset(m_eventCaptureActive ? 0 : m_recordingInterval * 1000000LL,
+                           !m_eventCaptureActive && m_captureThread->isAdaptive());
+    if (m_eventCaptureActive && count == 0) {
+        appendPoint(MousePoint(CaptureThread::cursorPosition(), 0));
+    }
+    for (int i = 0; i < count && !m_limitReached && !m_streamFailed; ++i) {
+        const CaptureSample& sample = m_preRoll[(first + i) % m_preRoll.size()];
+        m_statsCollector.addSample(sample.timestampNs, sample.deadlineNs, sample.missedTicks);
+        appendSample(MousePoint(sample.position, sample.timestampNs - m_sessionStartNs));
+    }
+    m_preRollHead = 0;
+    m_preRollCount = 0;
+
+    m_lastProgress.start();
+    emit recordingStarted();
+    return true;
+}
+
+// 重置单次录制的状态
+void MouseRecorder::resetRecordingState()
+{
+    m_recordedPath.clear();
+    m_limitReached = false;
+    m_streamFailed = false;
+    m_totalPointCount = 0;
+    m_hasPendingHold = false;
+    m_suppressedCount = 0;
+    m_isRecording = true;
+}
+
+// 流式模式：预先打开目标文件，以便逐块追加
+void MouseRecorder::openStreamingTarget()
+{
+    m_recordingWasStreamed = false;
+    m_segments.clear();
+    m_segmentIndex = 0;
+    if (m_streamingTarget) {
+        QString name = segmentationEnabled() ? m_streamingTarget->generateSegmentFilename(m_recordingStartTime, 1)
+                                             : QString();
+        m_streamWriter = m_streamingTarget->beginPathStream(m_recordingStartTime, name);
+        if (m_streamWriter) {
+            m_recordingWasStreamed = true;
+            m_segmentIndex = 1;
+            m_lastStreamFlush.start();
+        } else {
+            qWarning() << "Failed to start streaming, recording in memory:" << m_streamingTarget->getLastError();
+            emit streamingError(m_streamingTarget->getLastError());
+        }
+    }
+}
+
+// 启动样本生产者：事件源或采集线程，返回是否为事件驱动采集
+bool MouseRecorder::startProducers()
+{
+    m_sampleQueue.clear();
+    m_sampleQueue.resetDroppedCount();
+
+    bool eventCapture = false;
+    if (m_captureMode == EventCapture) {
+        eventCapture = startEventCapture();
+        if (!eventCapture) {
+            qWarning() << "Pointer event capture unavailable, falling back to timer polling";
+        }
+    }
+
+    if (!eventCapture) {
+        m_captureThread->setInterval(m_recordingInterval);
+        m_captureThread->startCapture();
+    }
+
+    m_drainTimer->start();
+    return eventCapture;
+}
+
+// 停止录制：停止采集，取出队列中剩余样本并发出停止信号
 void MouseRecorder::stopRecording()
 {
     if (!m_isRecording) {
         return;
     }
 
-    m_recordingTimer->stop();
+    m_drainTimer->stop();
+    bool wasEventCapture = m_eventCaptureActive;
+    stopProducers();
+
+    // Everything sampled before the producers stopped belongs to this recording
+    drainQueue();
+
+    // Close a trailing suppressed hold with its last sample so the duration is kept
+    if (m_hasPendingHold && !m_limitReached) {
+        appendPoint(m_pendingHold);
+        m_hasPendingHold = false;
+    }
+
+    // Close the trailing hold so playback keeps the full recording duration
+    if (wasEventCapture && !m_limitReached && m_totalPointCount > 0) {
+        appendPoint(MousePoint(m_lastPoint.position(),
+                               CaptureThread::monotonicNowNs() - m_sessionStartNs));
+    }
+
+    // Write the final partial block and publish the finished file
+    if (m_streamWriter) {
+        flushStreamBlock();
+        finishSegment();
+    }
+
+    // Segmented session: the manifest ties the segments into one recording
+    if (!m_segments.isEmpty()) {
+        if (!m_streamingTarget->saveSessionManifest(m_recordingStartTime, m_segments)) {
+            qWarning() << "Failed to save session manifest:" << m_streamingTarget->getLastError();
+        }
+    }
+
+    if (m_sampleQueue.droppedCount() > 0) {
+        qWarning() << "Capture queue overflowed," << m_sampleQueue.droppedCount() << "samples dropped";
+    }
+
     m_isRecording = false;
 
+    // Final progress so listeners see the exact totals
+    emitProgress();
+
     emit recordingStopped();
+
+    // Always-on mode: go back to filling the ring
+    if (m_flightRecorderActive) {
+        armFlightRecorder();
+    }
 }
 
 // 返回当前是否正在录制
@@ -66,10 +258,110 @@ bool MouseRecorder::isRecording() const
     return m_isRecording;
 }
 
-// 获取录制的鼠标路径数据
-QList<MousePoint> MouseRecorder::getRecordedPath() const
+// 获取录制数据的只读视图（不复制）
+SampleView MouseRecorder::recordedPath() const
+{
+    return m_recordedPath.view();
+}
+
+// 获取录制开始的墙上时间
+QDateTime MouseRecorder::recordingStartTime() const
+{
+    return m_recordingStartTime;
+}
+
+// 获取本次录制的总点数（包括已写入磁盘的块）
+int MouseRecorder::recordedPointCount() const
+{
+    return m_totalPointCount;
+}
+
+// 设置内存预算（字节），仅用于非流式录制
+void MouseRecorder::setMemoryBudget(qint64 bytes)
 {
-    return m_recordedPath;
+    m_memoryBudget = qMax(bytes, SampleStore::FIXED_BYTES * 2);
+}
+
+// 获取内存预算
+qint64 MouseRecorder::memoryBudget() const
+{
+    return m_memoryBudget;
+}
+
+// 获取内存中录制数据占用的字节数
+qint64 MouseRecorder::recordedMemoryBytes() const
+{
+    return m_recordedPath.memoryBytes();
+}
+
+// 获取实测的每个样本字节数
+double MouseRecorder::bytesPerSample() const
+{
+    return m_recordedPath.bytesPerSealedPoint();
+}
+
+// 按当前采样速率估算达到内存预算前的剩余时间
+qint64 MouseRecorder::projectedRemainingMs() const
+{
+    double perSample = bytesPerSample();
+    qint64 elapsedNs = CaptureThread::monotonicNowNs() - m_sessionStartNs;
+    if (perSample <= 0.0 || elapsedNs <= 0 || m_recordedPath.isEmpty()) {
+        return -1;
+    }
+
+    double samplesPerMs = m_recordedPath.size() * 1e6 / elapsedNs;
+    qint64 remainingBytes = qMax(0LL, m_memoryBudget - m_recordedPath.memoryBytes());
+    return static_cast<qint64>(remainingBytes / perSample / samplesPerMs);
+}
+
+// 设置流式保存目标：为空时录制数据保存在内存中
+void MouseRecorder::setStreamingTarget(PathManager *pathManager)
+{
+    m_streamingTarget = pathManager;
+}
+
+// 获取流式保存目标
+PathManager* MouseRecorder::streamingTarget() const
+{
+    return m_streamingTarget;
+}
+
+// 当前或上一次录制是否已流式写入磁盘
+bool MouseRecorder::recordingWasStreamed() const
+{
+    return m_recordingWasStreamed;
+}
+
+// 设置分段滚动阈值：文件大小、点数、时长（0表示不限制）
+void MouseRecorder::setSegmentLimits(qint64 maxBytes, int maxPoints, qint64 maxDurationMs)
+{
+    m_segmentMaxBytes = qMax(0LL, maxBytes);
+    m_segmentMaxPoints = qMax(0, maxPoints);
+    m_segmentMaxDurationMs = qMax(0LL, maxDurationMs);
+}
+
+// 是否启用了分段滚动
+bool MouseRecorder::segmentationEnabled() const
+{
+    return m_segmentMaxBytes > 0 || m_segmentMaxPoints > 0 || m_segmentMaxDurationMs > 0;
+}
+
+// 当前或上一次流式录制的分段数
+int MouseRecorder::segmentCount() const
+{
+    return m_segmentIndex;
+}
+
+// 设置进度通知频率（每秒次数）
+void MouseRecorder::setProgressRate(int hz)
+{
+    m_progressIntervalMs = 1000 / qBound(1, hz, 1000);
+}
+
+// 获取进度通知频率
+int MouseRecorder::progressRate() const
+{
+    return 1000 / m_progressIntervalMs;
 }
 
 // 清空录制的路径数据
@@ -78,11 +370,23 @@ void MouseRecorder::clearRecordedPath()
     m_recordedPath.clear();
 }
 
-// 设置录制间隔：调整定时器的采样频率
+// 取出录制结果：解码一次后释放录制缓冲
+PathHandle MouseRecorder::takeRecordedPath()
+{
+    if (m_isRecording || m_recordingWasStreamed || m_recordedPath.isEmpty()) {
+        return PathHandle();
+    }
+
+    PathHandle path = makePathHandle(m_recordedPath.view().toPathBuffer());
+    m_recordedPath.clear();
+    return path;
+}
+
+// 设置录制间隔：调整采集线程的采样频率
 void MouseRecorder::setRecordingInterval(int intervalMs)
 {
     m_recordingInterval = intervalMs;
-    m_recordingTimer->setInterval(intervalMs);
+    m_captureThread->setInterval(intervalMs);
 }
 
 // 获取当前录制间隔设置
@@ -91,44 +395,394 @@ int MouseRecorder::recordingInterval() const
     return m_recordingInterval;
 }
 
-// 录制当前鼠标位置：使用Windows API获取高精度坐标
-void MouseRecorder::recordCurrentPosition()
+// 设置采集模式：定时轮询或指针事件驱动
+void MouseRecorder::setCaptureMode(CaptureMode mode)
 {
-    if (!m_isRecording) {
+    m_captureMode = mode;
+}
+
+// 获取当前采集模式
+MouseRecorder::CaptureMode MouseRecorder::captureMode() const
+{
+    return m_captureMode;
+}
+
+// 设置自适应采样频率（仅定时轮询）
+void MouseRecorder::setAdaptiveRate(bool adaptive)
+{
+    m_captureThread->setAdaptive(adaptive);
+}
+
+// 获取是否启用自适应采样频率
+bool MouseRecorder::adaptiveRate() const
+{
+    return m_captureThread->isAdaptive();
+}
+
+// 设置快速移动时是否提高采样频率
+void MouseRecorder::setVelocityBoost(bool boost)
+{
+    if (boost == velocityBoost()) {
         return;
     }
 
-    QPoint currentPos;
+    m_captureThread->setVelocityBoost(boost);
+
+    // The pre-roll ring is sized for the peak sampling rate
+    if (m_flightRecorderActive) {
+        startFlightRecorder(m_flightRecorderSeconds);
+    }
+}
+
+// 获取是否在快速移动时提高采样频率
+bool MouseRecorder::velocityBoost() const
+{
+    return m_captureThread->velocityBoost();
+}
+
+// 设置是否跳过静止样本
+void MouseRecorder::setSuppressStationary(bool suppress)
+{
+    m_suppressStationary = suppress;
+}
+
+// 获取是否跳过静止样本
+bool MouseRecorder::suppressStationary() const
+{
+    return m_suppressStationary;
+}
 
-#ifdef Q_OS_WIN
-    // Use Windows API to get cursor position for consistency with playback
-    POINT winPos;
-    if (GetCursorPos(&winPos)) {
-        currentPos = QPoint(winPos.x, winPos.y);
+// 获取本次录制跳过的静止样本数
+int MouseRecorder::suppressedSampleCount() const
+{
+    return m_suppressedCount;
+}
+
+// 获取本次录制的采样质量统计
+CaptureStats MouseRecorder::captureStats() const
+{
+    return m_statsCollector.stats();
+}
+
+// 启动飞行记录器：预分配环形缓冲并开始持续采集
+void MouseRecorder::startFlightRecorder(int preRollSeconds)
+{
+    m_flightRecorderSeconds = qBound(1, preRollSeconds, MAX_PRE_ROLL_SECONDS);
+
+    // Size for the fastest rate the producer can reach: velocity boost samples up to four
+    // times the base rate (never above 1kHz), and pointer events follow the device report
+    // rate. Anything beyond the window is trimmed by timestamp when the ring is saved.
+    int samplesPerSecond;
+    if (m_captureMode == EventCapture) {
+        samplesPerSecond = MAX_EVENT_RATE_HZ;
+    } else if (velocityBoost()) {
+        samplesPerSecond = qMin(1000, qMax(1, 4000 / m_recordingInterval));
     } else {
-        // Fallback to Qt if Windows API fails
-        currentPos = QCursor::pos();
+        samplesPerSecond = qMax(1, 1000 / m_recordingInterval);
+    }
+    m_preRoll.resize(m_flightRecorderSeconds * samplesPerSecond + 1);
+    m_preRoll.squeeze();
+    m_flightRecorderActive = true;
+
+    if (!m_isRecording) {
+        // Restart so producer settings and ring size match
+        if (m_flightRecorderArmed) {
+            m_drainTimer->stop();
+            stopProducers();
+        }
+        armFlightRecorder();
+    }
+}
+
+// 停止飞行记录器并释放环形缓冲
+void MouseRecorder::stopFlightRecorder()
+{
+    if (!m_flightRecorderActive) {
+        return;
+    }
+
+    m_flightRecorderActive = false;
+    if (m_flightRecorderArmed) {
+        m_drainTimer->stop();
+        stopProducers();
+        m_flightRecorderArmed = false;
+    }
+
+    m_preRoll.clear();
+    m_preRoll.squeeze();
+    m_preRollHead = 0;
+    m_preRollCount = 0;
+}
+
+// 飞行记录器是否启用
+bool MouseRecorder::isFlightRecorderActive() const
+{
+    return m_flightRecorderActive;
+}
+
+// 获取预录时长（秒）
+int MouseRecorder::flightRecorderSeconds() const
+{
+    return m_flightRecorderSeconds;
+}
+
+// 开始填充环形缓冲
+void MouseRecorder::armFlightRecorder()
+{
+    m_preRollHead = 0;
+    m_preRollCount = 0;
+    startProducers();
+    m_flightRecorderArmed = true;
+}
+
+// 取出队列样本写入环形缓冲：覆盖最旧的样本，不分配内存
+void MouseRecorder::drainIntoPreRoll()
+{
+    const size_t batchSize = 256;
+    CaptureSample batch[batchSize];
+    const int capacity = m_preRoll.size();
+
+    size_t count;
+    while ((count = m_sampleQueue.popBatch(batch, batchSize)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            m_preRoll[m_preRollHead] = batch[i];
+            m_preRollHead = (m_preRollHead + 1) % capacity;
+            m_preRollCount = qMin(m_preRollCount + 1, capacity);
+        }
+    }
+}
+
+// 替换指针事件源（接管所有权）
+void MouseRecorder::setPointerEventSource(PointerEventSource *source)
+{
+    if (m_eventSource == source) {
+        return;
+    }
+
+    if (m_eventSource) {
+        m_eventSource->stop();
+        m_eventCaptureActive = false;
+        delete m_eventSource;
+    }
+
+    m_eventSource = source;
+    if (m_eventSource) {
+        m_eventSource->setParent(this);
+        m_eventSource->setSampleQueue(&m_sampleQueue);
+    }
+}
+
+// 获取当前指针事件源
+PointerEventSource* MouseRecorder::pointerEventSource() const
+{
+    return m_eventSource;
+}
+
+// 启动事件驱动采集：必要时创建平台原生事件源
+bool MouseRecorder::startEventCapture()
+{
+    if (!m_eventSource) {
+        setPointerEventSource(PointerEventSource::createNative(this));
+    }
+
+    if (!m_eventSource || !m_eventSource->start()) {
+        return false;
+    }
+
+    qDebug() << "Recording with pointer event source:" << m_eventSource->name();
+    m_eventCaptureActive = true;
+    return true;
+}
+
+// 停止所有样本生产者（采集线程和事件源）
+void MouseRecorder::stopProducers()
+{
+    if (m_captureThread->isRunning()) {
+        m_captureThread->requestStop();
+        m_captureThread->wait();
+    }
+
+    if (m_eventCaptureActive) {
+        m_eventSource->stop();
+        m_eventCaptureActive = false;
+    }
+}
+
+// 定时取出采集队列：批量追加样本，达到上限时停止录制
+void MouseRecorder::drainCapturedSamples()
+{
+    // Without a native cursor query the capture thread samples what the GUI thread last saw
+    m_captureThread->publishCursorPosition();
+
+    if (m_flightRecorderArmed) {
+        drainIntoPreRoll();
+        return;
     }
-#else
-    currentPos = QCursor::pos();
-#endif
 
-    // Use high precision timestamp for better playback accuracy
-    QDateTime timestamp = QDateTime::currentDateTime();
-    timestamp.setMSecsSinceEpoch(QDateTime::currentMSecsSinceEpoch());
+    if (!m_isRecording) {
+        return;
+    }
+
+    drainQueue();
+
+    // Bound the checkpoint cadence when samples arrive slowly
+    if (m_streamWriter && !m_streamFailed && !m_recordedPath.isEmpty() &&
+        m_lastStreamFlush.elapsed() >= STREAM_FLUSH_INTERVAL_MS) {
+        flushStreamBlock();
+        rollOverIfNeeded();
+    }
+
+    if (m_lastProgress.elapsed() >= m_progressIntervalMs) {
+        emitProgress();
+    }
+
+    if (m_streamFailed) {
+        QString error = m_streamWriter ? m_streamWriter->errorString() : m_streamingTarget->getLastError();
+        qWarning() << "Streaming to disk failed, stopping recording:" << error;
+        stopRecording();
+        emit streamingError(error);
+    } else if (m_limitReached) {
+        qWarning() << "Recording memory budget reached (" << m_memoryBudget << "bytes). Stopping recording.";
+        stopRecording();
+        emit recordingLimitReached();
+    }
+}
 
-    // qDebug() << "Recording point" << m_recordedPath.size() + 1 << "at position:" << currentPos
-    //          << "timestamp:" << timestamp.toString("hh:mm:ss.zzz");
+// 发出合并后的录制进度通知
+void MouseRecorder::emitProgress()
+{
+    m_lastProgress.restart();
+    qint64 elapsedMs = (CaptureThread::monotonicNowNs() - m_sessionStartNs) / 1000000;
+    emit recordingProgress(m_totalPointCount, m_lastPoint, elapsedMs);
+}
+
+// 将当前块写入磁盘并清空内存中的块
+void MouseRecorder::flushStreamBlock()
+{
+    if (!m_streamWriter || m_streamFailed) {
+        return;
+    }
+
+    if (!m_streamWriter->append(m_recordedPath.view())) {
+        m_streamFailed = true;
+        return;
+    }
+
+    m_recordedPath.clear();
+    m_lastStreamFlush.restart();
+}
+
+// 分段滚动：当前分段达到阈值时关闭它并在同一会话中打开下一个分段
+void MouseRecorder::rollOverIfNeeded()
+{
+    if (!segmentationEnabled() || !m_streamWriter || m_streamFailed) {
+        return;
+    }
 
-    MousePoint point(currentPos, timestamp);
+    qint64 durationMs = (m_streamWriter->lastTimestampNs() - m_streamWriter->firstTimestampNs()) / 1000000;
+    bool limitReached = (m_segmentMaxBytes > 0 && m_streamWriter->fileSize() >= m_segmentMaxBytes) ||
+                        (m_segmentMaxPoints > 0 && m_streamWriter->pointCount() >= m_segmentMaxPoints) ||
+                        (m_segmentMaxDurationMs > 0 && durationMs >= m_segmentMaxDurationMs);
+    if (!limitReached) {
+        return;
+    }
+
+    finishSegment();
+
+    // The header of each segment carries its own wall-clock start
+    m_segmentIndex++;
+    qint64 elapsedMs = (CaptureThread::monotonicNowNs() - m_sessionStartNs) / 1000000;
+    QString name = m_streamingTarget->generateSegmentFilename(m_recordingStartTime, m_segmentIndex);
+    m_streamWriter = m_streamingTarget->beginPathStream(m_recordingStartTime.addMSecs(elapsedMs), name);
+    if (!m_streamWriter) {
+        m_streamFailed = true;
+        return;
+    }
+
+    m_lastStreamFlush.restart();
+    qDebug() << "Rolled over to recording segment" << m_segmentIndex;
+    emit segmentRolledOver(m_segmentIndex);
+}
+
+// 关闭当前分段文件，并记录到会话清单
+void MouseRecorder::finishSegment()
+{
+    SessionSegment segment;
+    segment.filename = QFileInfo(m_streamWriter->filePath()).fileName();
+    segment.startOffsetNs = m_streamWriter->firstTimestampNs();
+    segment.pointCount = m_streamWriter->pointCount();
+
+    m_streamWriter->setCaptureStats(m_statsCollector.stats());
+    bool saved = m_streamingTarget->finishPathStream(m_streamWriter);
+    m_streamWriter = nullptr;
+
+    // finishPathStream removes empty files, so they never reach the manifest
+    if (saved && segmentationEnabled()) {
+        m_segments.append(segment);
+    }
+}
+
+// 批量取出队列中的样本并追加到录制路径
+void MouseRecorder::drainQueue()
+{
+    const size_t batchSize = 256;
+    CaptureSample batch[batchSize];
+
+    while (!m_limitReached && !m_streamFailed) {
+        size_t count = m_sampleQueue.popBatch(batch, batchSize);
+        if (count == 0) {
+            break;
+        }
+
+        for (size_t i = 0; i < count && !m_limitReached && !m_streamFailed; ++i) {
+            const CaptureSample& sample = batch[i];
+            m_statsCollector.addSample(sample.timestampNs, sample.deadlineNs, sample.missedTicks);
+            appendSample(MousePoint(sample.position, sample.timestampNs - m_sessionStartNs));
+        }
+    }
+}
+
+// 追加采集样本：静止抑制模式下位置未变化的样本只保留为待定的停留点
+void MouseRecorder::appendSample(const MousePoint& point)
+{
+    if (m_suppressStationary && m_totalPointCount > 0 && point.position() == m_lastPoint.position()) {
+        if (m_hasPendingHold) {
+            m_suppressedCount++;
+        }
+        m_pendingHold = point;
+        m_hasPendingHold = true;
+        return;
+    }
+
+    // The hold ends at the next change's timestamp, which the player already waits for
+    if (m_hasPendingHold) {
+        m_suppressedCount++;
+        m_hasPendingHold = false;
+    }
+
+    appendPoint(point);
+}
+
+// 追加录制点：发出信号并检查录制上限
+void MouseRecorder::appendPoint(const MousePoint& point)
+{
     m_recordedPath.append(point);
+    m_lastPoint = point;
+    m_totalPointCount++;
 
     emit pointRecorded(point);
 
-    // Check if we've reached the maximum recording limit
-    if (m_recordedPath.size() >= MAX_RECORDING_POINTS) {
-        qWarning() << "Recording limit reached (" << MAX_RECORDING_POINTS << " points). Stopping recording.";
-        emit recordingLimitReached();
-        stopRecording();
+    if (m_streamWriter) {
+        // Streaming mode: memory holds one block at most. The segment point limit is
+        // exact, so a partial block is flushed when it would complete the segment
+        bool segmentFull = m_segmentMaxPoints > 0 &&
+                           m_streamWriter->pointCount() + m_recordedPath.size() >= m_segmentMaxPoints;
+        if (m_recordedPath.size() >= STREAM_BLOCK_POINTS || segmentFull) {
+            flushStreamBlock();
+            rollOverIfNeeded();
+        }
+    } else if (m_recordedPath.memoryBytes() >= m_memoryBudget) {
+        // Check if we've reached the memory budget
+        m_limitReached = true;
     }
 }
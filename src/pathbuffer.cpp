@@ -0,0 +1,240 @@
+#include "pathbuffer.h"
+#include <QFile>
+#include <algorithm>
+#include <utility>
+
+// 空路径
+PathBuffer::PathBuffer()
+    : m_mappedX(nullptr)
+    , m_mappedY(nullptr)
+    , m_mappedTimestampNs(nullptr)
+    , m_mappedCount(0)
+{
+}
+
+// 基于内存映射文件的只读视图，不复制数据
+PathBuffer PathBuffer::fromMapping(const QSharedPointer<QFile>& file, const qint32 *x,
+                                   const qint32 *y, const qint64 *timestampNs, int count)
+{
+    PathBuffer path;
+    path.m_mapping = file;
+    path.m_mappedX = x;
+    path.m_mappedY = y;
+    path.m_mappedTimestampNs = timestampNs;
+    path.m_mappedCount = count;
+    return path;
+}
+
+bool PathBuffer::isMapped() const
+{
+    return !m_mapping.isNull();
+}
+
+int PathBuffer::size() const
+{
+    return isMapped() ? m_mappedCount : m_timestampNs.size();
+}
+
+bool PathBuffer::isEmpty() const
+{
+    return size() == 0;
+}
+
+// 预分配三列的容量
+void PathBuffer::reserve(int count)
+{
+    detach();
+    m_x.reserve(count);
+    m_y.reserve(count);
+    m_timestampNs.reserve(count);
+}
+
+// 调整点数（新增的点在写入前为0）
+void PathBuffer::resize(int count)
+{
+    detach();
+    m_x.resize(count);
+    m_y.resize(count);
+    m_timestampNs.resize(count);
+}
+
+void PathBuffer::clear()
+{
+    m_mapping.reset();
+    m_mappedCount = 0;
+    m_x.clear();
+    m_y.clear();
+    m_timestampNs.clear();
+}
+
+// 追加一个点
+void PathBuffer::append(int x, int y, qint64 timestampNs)
+{
+    detach();
+    m_x.append(x);
+    m_y.append(y);
+    m_timestampNs.append(timestampNs);
+}
+
+void PathBuffer::append(const MousePoint& point)
+{
+    append(point.position().x(), point.position().y(), point.timestampNs());
+}
+
+// 追加连续存放的点（例如录制缓冲解码出的块）
+void PathBuffer::append(const MousePoint *points, int count)
+{
+    reserve(size() + count);
+    for (int i = 0; i < count; ++i) {
+        append(points[i]);
+    }
+}
+
+// 从三列数据批量追加（例如解码器输出）
+void PathBuffer::append(const qint32 *x, const qint32 *y, const qint64 *timestampNs, int count)
+{
+    detach();
+    int start = size();
+    m_x.resize(start + count);
+    m_y.resize(start + count);
+    m_timestampNs.resize(start + count);
+    std::copy(x, x + count, m_x.data() + start);
+    std::copy(y, y + count, m_y.data() + start);
+    std::copy(timestampNs, timestampNs + count, m_timestampNs.data() + start);
+}
+
+// 追加另一条路径，时间整体平移offsetNs
+void PathBuffer::append(const PathBuffer& other, qint64 offsetNs)
+{
+    int start = size();
+    append(other.xData(), other.yData(), other.timestampData(), other.size());
+
+    if (offsetNs != 0) {
+        qint64 *shifted = m_timestampNs.data();
+        for (int i = start; i < m_timestampNs.size(); ++i) {
+            shifted[i] += offsetNs;
+        }
+    }
+}
+
+MousePoint PathBuffer::at(int index) const
+{
+    return MousePoint(xData()[index], yData()[index], timestampData()[index]);
+}
+
+MousePoint PathBuffer::first() const
+{
+    return at(0);
+}
+
+MousePoint PathBuffer::last() const
+{
+    return at(size() - 1);
+}
+
+QPoint PathBuffer::position(int index) const
+{
+    return QPoint(xData()[index], yData()[index]);
+}
+
+qint64 PathBuffer::timestampNs(int index) const
+{
+    return timestampData()[index];
+}
+
+const qint32* PathBuffer::xData() const
+{
+    return isMapped() ? m_mappedX : m_x.constData();
+}
+
+const qint32* PathBuffer::yData() const
+{
+    return isMapped() ? m_mappedY : m_y.constData();
+}
+
+const qint64* PathBuffer::timestampData() const
+{
+    return isMapped() ? m_mappedTimestampNs : m_timestampNs.constData();
+}
+
+qint32* PathBuffer::writableXData()
+{
+    detach();
+    return m_x.data();
+}
+
+qint32* PathBuffer::writableYData()
+{
+    detach();
+    return m_y.data();
+}
+
+qint64* PathBuffer::writableTimestampData()
+{
+    detach();
+    return m_timestampNs.data();
+}
+
+// 路径总时长（纳秒）
+qint64 PathBuffer::durationNs() const
+{
+    return isEmpty() ? 0 : timestampNs(size() - 1) - timestampNs(0);
+}
+
+// 路径经过的最小外接矩形
+QRect PathBuffer::bounds() const
+{
+    if (isEmpty()) {
+        return QRect();
+    }
+
+    const qint32 *x = xData();
+    const qint32 *y = yData();
+    auto xRange = std::minmax_element(x, x + size());
+    auto yRange = std::minmax_element(y, y + size());
+    return QRect(QPoint(*xRange.first, *yRange.first), QPoint(*xRange.second, *yRange.second));
+}
+
+// 整体平移位置
+void PathBuffer::translate(int dx, int dy)
+{
+    detach();
+    qint32 *x = m_x.data();
+    qint32 *y = m_y.data();
+    for (int i = 0; i < m_x.size(); ++i) {
+        x[i] += dx;
+    }
+    for (int i = 0; i < m_y.size(); ++i) {
+        y[i] += dy;
+    }
+}
+
+// 整体平移时间
+void PathBuffer::shiftTime(qint64 offsetNs)
+{
+    detach();
+    qint64 *t = m_timestampNs.data();
+    for (int i = 0; i < m_timestampNs.size(); ++i) {
+        t[i] += offsetNs;
+    }
+}
+
+// 修改前把映射的列复制到自有数组并释放映射
+void PathBuffer::detach()
+{
+    if (!isMapped()) {
+        return;
+    }
+
+    m_x = QVector<qint32>(m_mappedX, m_mappedX + m_mappedCount);
+    m_y = QVector<qint32>(m_mappedY, m_mappedY + m_mappedCount);
+    m_timestampNs = QVector<qint64>(m_mappedTimestampNs, m_mappedTimestampNs + m_mappedCount);
+    m_mapping.reset();
+    m_mappedCount = 0;
+}
+
+// 把完成的路径移入共享句柄
+PathHandle makePathHandle(PathBuffer&& path)
+{
+    return PathHandle(new PathBuffer(std::move(path)));
+}
@@ -0,0 +1,288 @@
+#include "pathcodec.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define PATHCODEC_SSSE3
+#include <tmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define PATHCODEC_TARGET_SSSE3
+#else
+#define PATHCODEC_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#endif
+
+namespace PathCodec {
+
+namespace {
+
+// Stream VByte：每个值的字节数（1-4）
+int valueBytes(quint32 value)
+{
+    return value < (1u << 8) ? 1 : value < (1u << 16) ? 2 : value < (1u << 24) ? 3 : 4;
+}
+
+// 控制字节中第index个值的字节数
+int controlBytes(uchar control, int index)
+{
+    return ((control >> (index * 2)) & 3) + 1;
+}
+
+// 标量解码坐标流中[first, count)的值，接着carry继续累加
+bool decodeValuesScalar(const uchar *control, const uchar *&data, const uchar *end,
+                        int first, int count, quint32 carry[2], qint32 *x, qint32 *y)
+{
+    for (int k = first; k < count; ++k) {
+        int bytes = controlBytes(control[k >> 2], k & 3);
+        if (end - data < bytes) {
+            return false;
+        }
+        quint32 value = 0;
+        for (int b = 0; b < bytes; ++b) {
+            value |= static_cast<quint32>(data[b]) << (b * 8);
+        }
+        data += bytes;
+
+        // Even values are x deltas, odd values y deltas
+        qint32 *column = k & 1 ? y : x;
+        carry[k & 1] += unzigzag32(value);
+        column[k >> 1] = static_cast<qint32>(carry[k & 1]);
+    }
+    return true;
+}
+
+#ifdef PATHCODEC_SSSE3
+// 每个控制字节对应的pshufb掩码和数据长度
+struct StreamVByteTables
+{
+    uchar shuffle[256][16];
+    uchar length[256];
+
+    StreamVByteTables()
+    {
+        for (int control = 0; control < 256; ++control) {
+            int offset = 0;
+            for (int index = 0; index < 4; ++index) {
+                int bytes = controlBytes(static_cast<uchar>(control), index);
+                for (int b = 0; b < 4; ++b) {
+                    // 0x80 zeroes the byte
+                    shuffle[control][index * 4 + b] = b < bytes ? static_cast<uchar>(offset + b) : 0x80;
+                }
+                offset += bytes;
+            }
+            length[control] = static_cast<uchar>(offset);
+        }
+    }
+};
+
+const StreamVByteTables& streamVByteTables()
+{
+    static const StreamVByteTables tables;
+    return tables;
+}
+
+bool cpuHasSsse3()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+// SSSE3解码：每个控制字节展开两个点，返回已解码的值个数
+// Stops while a full 16-byte load still fits before end; the scalar loop decodes the rest.
+PATHCODEC_TARGET_SSSE3
+int decodeValuesSsse3(const uchar *control, const uchar *&data, const uchar *end,
+                      int count, quint32 carry[2], qint32 *x, qint32 *y)
+{
+    const StreamVByteTables& tables = streamVByteTables();
+    const __m128i one = _mm_set1_epi32(1);
+    __m128i previous = _mm_set_epi32(static_cast<int>(carry[1]), static_cast<int>(carry[0]),
+                                     static_cast<int>(carry[1]), static_cast<int>(carry[0]));
+
+    int groups = count / 4;
+    int group = 0;
+    for (; group < groups && end - data >= 16; ++group) {
+        uchar c = control[group];
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.shuffle[c]));
+        data += tables.length[c];
+
+        // [zdx0, zdy0, zdx1, zdy1] -> signed deltas
+        __m128i zigzagged = _mm_shuffle_epi8(packed, mask);
+        __m128i delta = _mm_xor_si128(_mm_srli_epi32(zigzagged, 1),
+                                      _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(zigzagged, one)));
+
+        // Prefix sum over the two points, then add the last decoded point
+        __m128i sum = _mm_add_epi32(delta, _mm_slli_si128(delta, 8));
+        __m128i points = _mm_add_epi32(sum, previous);
+        previous = _mm_shuffle_epi32(points, _MM_SHUFFLE(3, 2, 3, 2));
+
+        // [x0, y0, x1, y1] -> [x0, x1, y0, y1]
+        __m128i columns = _mm_shuffle_epi32(points, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(x + group * 2), columns);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(y + group * 2), _mm_srli_si128(columns, 8));
+    }
+
+    carry[0] = static_cast<quint32>(_mm_cvtsi128_si32(previous));
+    carry[1] = static_cast<quint32>(_mm_cvtsi128_si32(_mm_srli_si128(previous, 4)));
+    return group * 4;
+}
+#endif
+
+// 解码坐标流：可用时先走SSSE3路径，剩余部分用标量循环
+bool decodeValues(const uchar *control, const uchar *&data, const uchar *end, int count,
+                  qint32 *x, qint32 *y)
+{
+    quint32 carry[2] = { 0, 0 };
+    int decoded = 0;
+#ifdef PATHCODEC_SSSE3
+    static const bool ssse3 = cpuHasSsse3();
+    if (ssse3) {
+        decoded = decodeValuesSsse3(control, data, end, count, carry, x, y);
+    }
+#endif
+    return decodeValuesScalar(control, data, end, decoded, count, carry, x, y);
+}
+
+} // namespace
+
+// 差分+游程编码
+void DeltaRunLengthCodec::encode(const qint32 *x, const qint32 *y, const qint64 *timestampUs, int count, QByteArray& out)
+{
+    // Time: runs of equal steps, each step relative to the previous point (or 0)
+    QByteArray runs;
+    int runCount = 0;
+    qint64 previousUs = 0;
+    for (int i = 0; i < count;) {
+        qint64 step = timestampUs[i] - previousUs;
+        int length = 1;
+        while (i + length < count && timestampUs[i + length] - timestampUs[i + length - 1] == step) {
+            ++length;
+        }
+        putVarint(runs, zigzag(step));
+        putVarint(runs, static_cast<quint64>(length));
+        ++runCount;
+        i += length;
+        previousUs = timestampUs[i - 1];
+    }
+    putVarint(out, static_cast<quint64>(runCount));
+    out.append(runs);
+
+    // Coordinates: control bytes, then the value bytes
+    int values = count * 2;
+    int controlStart = out.size();
+    out.append(QByteArray((values + 3) / 4, '\0'));
+    out.reserve(out.size() + values * 2);
+
+    quint32 previousX = 0;
+    quint32 previousY = 0;
+    for (int k = 0; k < values; ++k) {
+        int i = k >> 1;
+        quint32& previous = k & 1 ? previousY : previousX;
+        quint32 coordinate = static_cast<quint32>(k & 1 ? y[i] : x[i]);
+        quint32 value = zigzag32(coordinate - previous);
+        previous = coordinate;
+
+        int bytes = valueBytes(value);
+        out.data()[controlStart + (k >> 2)] |= static_cast<char>((bytes - 1) << ((k & 3) * 2));
+        for (int b = 0; b < bytes; ++b) {
+            out.append(static_cast<char>(value >> (b * 8)));
+        }
+    }
+}
+
+bool DeltaRunLengthCodec::decode(const uchar *p, const uchar *end, int count, qint32 *x, qint32 *y, qint64 *timestampNs)
+{
+    // Time runs
+    quint64 runCount;
+    if (!getVarint(p, end, runCount) || runCount > static_cast<quint64>(count)) {
+        return false;
+    }
+    qint64 us = 0;
+    int filled = 0;
+    for (quint64 run = 0; run < runCount; ++run) {
+        quint64 step, length;
+        if (!getVarint(p, end, step) || !getVarint(p, end, length) ||
+            length == 0 || length > static_cast<quint64>(count - filled)) {
+            return false;
+        }
+        qint64 stepUs = unzigzag(step);
+        for (quint64 j = 0; j < length; ++j) {
+            us += stepUs;
+            timestampNs[filled++] = us * 1000;
+        }
+    }
+    if (filled != count) {
+        return false;
+    }
+
+    // Coordinates
+    int values = count * 2;
+    const uchar *control = p;
+    if (end - control < (values + 3) / 4) {
+        return false;
+    }
+    const uchar *data = control + (values + 3) / 4;
+    return decodeValues(control, data, end, values, x, y) && data == end;
+}
+
+bool isKnown(quint8 id)
+{
+    return withCodec(id, [](auto) {});
+}
+
+// 编解码器名称（用于路径详情和诊断）
+QString name(quint8 id)
+{
+    if (id == MAPPED_COLUMNS) {
+        return "memory-mapped columns";
+    }
+
+    QString result = QString("unknown codec %1").arg(id);
+    withCodec(id, [&](auto codec) {
+        result = decltype(codec)::name();
+    });
+    return result;
+}
+
+int minBytesPerPoint(quint8 id)
+{
+    int result = 1;
+    withCodec(id, [&](auto codec) {
+        result = decltype(codec)::MIN_BYTES_PER_POINT;
+    });
+    return result;
+}
+
+// 编码一个块：时间转换为相对originNs的微秒后交给编解码器
+bool encodeBlock(quint8 id, const PathBuffer& path, int first, int count, qint64 originNs, QByteArray& out)
+{
+    QVector<qint64> timestampUs(count);
+    const qint64 *t = path.timestampData() + first;
+    qint64 *us = timestampUs.data();
+    for (int i = 0; i < count; ++i) {
+        us[i] = divideRounded(t[i] - originNs, 1000);
+    }
+
+    return withCodec(id, [&](auto codec) {
+        decltype(codec)::encode(path.xData() + first, path.yData() + first, us, count, out);
+    });
+}
+
+// 解码一个块，写入调用方预先分配的列
+bool decodeBlock(quint8 id, const QByteArray& data, int count, qint32 *x, qint32 *y, qint64 *timestampNs)
+{
+    const uchar *p = reinterpret_cast<const uchar*>(data.constData());
+    const uchar *end = p + data.size();
+
+    bool ok = false;
+    bool known = withCodec(id, [&](auto codec) {
+        ok = decltype(codec)::decode(p, end, count, x, y, timestampNs);
+    });
+    return known && ok;
+}
+
+} // namespace PathCodec
@@ -1,14 +1,58 @@
 #include "pathmanager.h"
+#include "pathstreamwriter.h"
+#include "pathcodec.h"
+#include "crc32c.h"
 #include <QStandardPaths>
 #include <QDataStream>
 #include <QFile>
 #include <QFileInfo>
 #include <QDebug>
 #include <QDir>
+#include <QRegularExpression>
+#include <QThreadPool>
+#include <QThread>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include <QtConcurrent>
+#include <utility>
+
+const char PathManager::SESSION_EXTENSION[] = ".msession";
+const char PathManager::DATE_FILENAME_FORMAT[] = "yyyy-MM-dd_hh-mm-ss";
+
+namespace {
+
+// 在全局线程池和调用线程上并行执行fn(0)...fn(count - 1)
+// Indices are taken from a shared counter, so uneven work balances out. The calling
+// thread works as well and waits only for helpers that actually started, so a busy
+// pool degrades to a plain loop instead of a stall.
+template <typename Fn>
+void parallelFor(int count, Fn fn)
+{
+    QAtomicInt next(0);
+    auto work = [&]() {
+        for (int i = next.fetchAndAddRelaxed(1); i < count; i = next.fetchAndAddRelaxed(1)) {
+            fn(i);
+        }
+    };
+
+    QSemaphore finished;
+    int helpers = 0;
+    int wanted = qMin(count, QThread::idealThreadCount()) - 1;
+    QThreadPool *pool = QThreadPool::globalInstance();
+    while (helpers < wanted && pool->tryStart([&]() { work(); finished.release(); })) {
+        ++helpers;
+    }
+
+    work();
+    finished.acquire(helpers);
+}
+
+} // namespace
 
 // 路径管理器构造函数：初始化数据目录路径
 PathManager::PathManager(QObject *parent)
     : QObject(parent)
+    , m_codec(PathCodec::DEFAULT_CODEC)
 {
     // Set default data directory
     QString defaultDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
@@ -16,7 +60,8 @@ PathManager::PathManager(QObject *parent)
 }
 
 // 保存鼠标路径：将路径数据序列化为.mpath文件
-bool PathManager::savePath(const QList<MousePoint>& path, const QString& name)
+bool PathManager::savePath(const PathBuffer& path, const QString& name, const QDateTime& recordedAt,
+                           const CaptureStats& captureStats)
 {
     if (path.isEmpty()) {
         qWarning() << "Path is empty, cannot save";
@@ -29,75 +74,226 @@ bool PathManager::savePath(const QList<MousePoint>& path, const QString& name)
     }
 
     QString fullPath = ensureDataDirectory() + "/" + filename;
+    QDateTime saveTime = recordedAt.isValid() ? recordedAt : QDateTime::currentDateTime();
 
-    QFile file(fullPath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to open file for writing:" << fullPath;
+    PathStreamWriter writer;
+    writer.setCodec(m_codec);
+    if (!writer.open(fullPath, saveTime) || !writer.append(path)) {
+        m_lastError = writer.errorString();
+        return false;
+    }
+
+    writer.setCaptureStats(captureStats);
+    if (!writer.close()) {
+        m_lastError = writer.errorString();
+        return false;
+    }
+
+    qDebug() << "Successfully saved" << path.size() << "points to" << filename << "using" << PathCodec::name(m_codec) << "codec";
+
+    emit pathSaved(filename);
+    return true;
+}
+
+// 设置保存新文件时使用的编解码器
+void PathManager::setPathCodec(quint8 codecId)
+{
+    bool valid = PathCodec::isKnown(codecId) || codecId == PathCodec::MAPPED_COLUMNS;
+    m_codec = valid ? codecId : PathCodec::DEFAULT_CODEC;
+}
+
+quint8 PathManager::pathCodec() const
+{
+    return m_codec;
+}
+
+// 开始流式保存：创建文件并返回写入器，录制过程中可多次追加
+PathStreamWriter* PathManager::beginPathStream(const QDateTime& recordedAt, const QString& name)
+{
+    m_lastError.clear();
+
+    QString filename = name.isEmpty() ? generateDateBasedFilename() : name;
+    if (!filename.endsWith(".mpath")) {
+        filename += ".mpath";
+    }
+
+    // V5 columns cannot grow, so streamed recordings fall back to the default block codec
+    PathStreamWriter *writer = new PathStreamWriter();
+    writer->setCodec(m_codec == PathCodec::MAPPED_COLUMNS ? PathCodec::DEFAULT_CODEC : m_codec);
+    if (!writer->open(ensureDataDirectory() + "/" + filename, recordedAt)) {
+        m_lastError = writer->errorString();
+        delete writer;
+        return nullptr;
+    }
+
+    qDebug() << "Streaming recording to" << filename;
+    return writer;
+}
+
+// 完成流式保存：关闭文件并释放写入器，空文件会被删除
+bool PathManager::finishPathStream(PathStreamWriter *writer)
+{
+    if (!writer) {
+        return false;
+    }
+
+    QString fullPath = writer->filePath();
+    QString filename = QFileInfo(fullPath).fileName();
+    int pointCount = writer->pointCount();
+    bool ok = writer->close();
+    if (!ok) {
+        m_lastError = writer->errorString();
+    }
+    delete writer;
+
+    if (pointCount == 0) {
+        QFile::remove(fullPath);
+        return false;
+    }
+
+    if (ok) {
+        qDebug() << "Finished streaming" << pointCount << "points to" << filename;
+        emit pathSaved(filename);
+    }
+    return ok;
+}
+
+// 保存会话清单：按顺序记录各分段文件及其起始偏移
+bool PathManager::saveSessionManifest(const QDateTime& sessionStart, const QList<SessionSegment>& segments)
+{
+    if (segments.isEmpty()) {
+        return false;
+    }
+
+    QString filename = sessionStart.toString(DATE_FILENAME_FORMAT) + SESSION_EXTENSION;
+    QFile file(ensureDataDirectory() + "/" + filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_lastError = QString("Failed to open session manifest for writing: %1").arg(file.errorString());
+        qWarning() << "Failed to open session manifest for writing:" << filename;
         return false;
     }
 
     QDataStream stream(&file);
     stream.setVersion(QDataStream::Qt_5_15);
+    stream << QString("MSESSION_V1") << sessionStart << qint32(segments.size());
+    for (const SessionSegment& segment : segments) {
+        stream << segment.filename << segment.startOffsetNs << qint32(segment.pointCount);
+    }
+
+    if (stream.status() != QDataStream::Ok || !file.flush()) {
+        m_lastError = "Failed to write session manifest";
+        qWarning() << "Failed to write session manifest, stream status:" << stream.status();
+        return false;
+    }
 
-    // Write file header
-    int pointCount = path.size();
-    QDateTime saveTime = QDateTime::currentDateTime();
+    qDebug() << "Saved session manifest" << filename << "with" << segments.size() << "segments";
+    emit pathSaved(filename);
+    return true;
+}
 
-    stream << QString("MPATH_V2"); // Updated file format version for relative time
-    stream << saveTime; // Save timestamp
-    stream << pointCount; // Number of points
+// 读取会话清单中的分段列表
+QList<SessionSegment> PathManager::getSessionSegments(const QString& manifestFilename) const
+{
+    QList<SessionSegment> segments;
 
-    if (stream.status() != QDataStream::Ok) {
-        qWarning() << "Failed to write file header, stream status:" << stream.status();
-        file.close();
-        return false;
+    QFile file(m_dataDirectory + "/" + manifestFilename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return segments;
     }
 
-    // Convert absolute timestamps to relative time differences and write points
-    QList<MousePoint> convertedPath;
-    for (int i = 0; i < path.size(); ++i) {
-        const MousePoint& originalPoint = path[i];
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
 
-        if (i == 0) {
-            // First point: deltaMs = 0
-            MousePoint convertedPoint(originalPoint.position(), 0);
-            convertedPath.append(convertedPoint);
-        } else {
-            // Calculate time difference from previous point
-            qint64 timeDiff = originalPoint.timestamp().toMSecsSinceEpoch() -
-                             path[i-1].timestamp().toMSecsSinceEpoch();
-            quint32 deltaMs = static_cast<quint32>(qMax(0LL, qMin(timeDiff, static_cast<qint64>(UINT32_MAX))));
+    QString version;
+    QDateTime sessionStart;
+    qint32 count;
+    stream >> version >> sessionStart >> count;
+    if (stream.status() != QDataStream::Ok || version != "MSESSION_V1" || count < 0) {
+        return segments;
+    }
 
-            MousePoint convertedPoint(originalPoint.position(), deltaMs);
-            convertedPath.append(convertedPoint);
+    for (qint32 i = 0; i < count; ++i) {
+        SessionSegment segment;
+        qint32 pointCount;
+        stream >> segment.filename >> segment.startOffsetNs >> pointCount;
+        if (stream.status() != QDataStream::Ok) {
+            return QList<SessionSegment>();
         }
+        segment.pointCount = pointCount;
+        segments.append(segment);
     }
 
-    // Write all converted points
-    for (int i = 0; i < convertedPath.size(); ++i) {
-        const MousePoint& point = convertedPath[i];
-        stream << point;
+    return segments;
+}
 
-        if (stream.status() != QDataStream::Ok) {
-            qWarning() << "Failed to write point" << i << "stream status:" << stream.status();
-            file.close();
-            return false;
+// 判断文件是否为会话清单
+bool PathManager::isSessionFile(const QString& filename)
+{
+    return filename.endsWith(SESSION_EXTENSION);
+}
+
+// 读取会话：依次读取各分段并按起始偏移拼接为一条连续路径
+PathBuffer PathManager::readSession(const QString& filename)
+{
+    PathBuffer path;
+
+    QList<SessionSegment> segments = getSessionSegments(filename);
+    if (segments.isEmpty()) {
+        m_lastError = QString("Session manifest is missing or corrupted: %1").arg(filename);
+        qWarning() << "Invalid session manifest:" << filename;
+        return path;
+    }
+
+    for (const SessionSegment& segment : segments) {
+        // Each segment's timestamps start at 0; the manifest places it on the session timeline
+        PathBuffer segmentPath = readPath(segment.filename);
+        if (segmentPath.isEmpty()) {
+            m_lastError = QString("Session segment %1 could not be loaded: %2").arg(segment.filename).arg(m_lastError);
+            return PathBuffer();
         }
+        path.append(segmentPath, segment.startOffsetNs);
     }
 
-    file.close();
-    qDebug() << "Successfully saved" << path.size() << "points to" << filename << "using relative time format";
+    qDebug() << "Loaded session" << filename << "with" << segments.size() << "segments," << path.size() << "points";
+    return path;
+}
 
-    emit pathSaved(filename);
-    return true;
+// 加载鼠标路径：读取一次并包装为共享的只读句柄
+PathHandle PathManager::loadPath(const QString& filename)
+{
+    m_lastError.clear();
+
+    // A damaged file still loads the chunks that survived; getLastError() reports the rest
+    PathBuffer path = isSessionFile(filename) ? readSession(filename) : readPath(filename);
+    if (path.isEmpty()) {
+        return PathHandle();
+    }
+
+    emit pathLoaded(filename);
+    return makePathHandle(std::move(path));
 }
 
-// 加载鼠标路径：从.mpath文件反序列化路径数据
-QList<MousePoint> PathManager::loadPath(const QString& filename)
+// 按时间范围加载：只解码与范围重叠的数据块
+PathHandle PathManager::loadPathRange(const QString& filename, qint64 fromNs, qint64 toNs)
 {
-    QList<MousePoint> path;
     m_lastError.clear();
 
+    PathBuffer path = isSessionFile(filename) ? readSession(filename) : readPath(filename, fromNs, toNs);
+    if (path.isEmpty()) {
+        if (m_lastError.isEmpty()) {
+            m_lastError = "The path has no points in the requested time range";
+        }
+        return PathHandle();
+    }
+
+    return makePathHandle(std::move(path));
+}
+
+// 读取鼠标路径：从.mpath文件反序列化路径数据
+PathBuffer PathManager::readPath(const QString& filename, qint64 fromNs, qint64 toNs)
+{
+    PathBuffer path;
+
     QString fullPath = m_dataDirectory + "/" + filename;
     QFile file(fullPath);
 
@@ -140,14 +336,53 @@ QList<MousePoint> PathManager::loadPath(const QString& filename)
         return path;
     }
 
-    if (version != "MPATH_V1" && version != "MPATH_V2") {
-        m_lastError = QString("Unsupported file format: %1 (Expected: MPATH_V1 or MPATH_V2)").arg(version);
-        qWarning() << "Unsupported file format:" << version << "Expected: MPATH_V1 or MPATH_V2";
+    if (version != "MPATH_V1" && version != "MPATH_V2" && version != "MPATH_V3" &&
+        version != "MPATH_V4" && version != "MPATH_V5" && version != "MPATH_V6" && version != "MPATH_V7") {
+        m_lastError = QString("Unsupported file format: %1 (Expected: MPATH_V1 to MPATH_V7)").arg(version);
+        qWarning() << "Unsupported file format:" << version << "Expected: MPATH_V1 to MPATH_V7";
         return path;
     }
 
-    if (pointCount < 0 || pointCount > 1000000) {
-        m_lastError = QString("Invalid point count: %1 (Expected: 0-1000000)").arg(pointCount);
+    // V4, V6 and V7 name the codec their blocks were written with, V5 where its columns
+    // start; V7 then has the summary block, which loading does not need
+    bool chunked = version == "MPATH_V6" || version == "MPATH_V7";
+    quint8 codecId = 0;
+    quint32 columnsOffset = 0;
+    int minPointBytes = MIN_POINT_RECORD_BYTES;
+    if (version == "MPATH_V4" || chunked) {
+        stream >> codecId;
+        if (stream.status() != QDataStream::Ok || !PathCodec::isKnown(codecId)) {
+            m_lastError = QString("Unsupported path codec: %1").arg(codecId);
+            qWarning() << "Unsupported path codec:" << codecId;
+            return path;
+        }
+        minPointBytes = PathCodec::minBytesPerPoint(codecId);
+
+        if (version == "MPATH_V7") {
+            PathSummary summary;
+            stream >> summary;
+            if (stream.status() != QDataStream::Ok) {
+                m_lastError = "File is corrupted or not a valid mouse path file";
+                qWarning() << "Failed to read path summary";
+                return path;
+            }
+        }
+    } else if (version == "MPATH_V5") {
+        stream >> columnsOffset;
+        if (stream.status() != QDataStream::Ok || columnsOffset % 8 != 0 ||
+            columnsOffset < file.pos() || columnsOffset > file.size()) {
+            m_lastError = "File is corrupted or not a valid mouse path file";
+            qWarning() << "Invalid column offset:" << columnsOffset;
+            return path;
+        }
+        minPointBytes = MAPPED_POINT_BYTES;
+    }
+
+    // Every point takes at least minPointBytes, so the file size bounds the count
+    qint64 dataStart = version == "MPATH_V5" ? columnsOffset : file.pos();
+    qint64 maxPoints = (file.size() - dataStart) / minPointBytes;
+    if (pointCount < 0 || pointCount > maxPoints) {
+        m_lastError = QString("Invalid point count: %1 (Expected: 0-%2 for this file size)").arg(pointCount).arg(maxPoints);
         qWarning() << "Invalid point count:" << pointCount;
         return path;
     }
@@ -158,52 +393,349 @@ QList<MousePoint> PathManager::loadPath(const QString& filename)
         return path;
     }
 
-    // Read all points based on file version
-    if (version == "MPATH_V1") {
-        // Legacy format: points contain absolute timestamps
-        for (int i = 0; i < pointCount; ++i) {
-            MousePoint point;
-            stream >> point;
-            if (stream.status() != QDataStream::Ok) {
-                m_lastError = QString("Failed to read mouse point %1 of %2 (File may be corrupted)").arg(i + 1).arg(pointCount);
-                qWarning() << "Failed to read point" << i << "Stream status:" << stream.status();
-                return path;
+    // V5 columns are used where they lie in the file
+    if (version == "MPATH_V5") {
+        file.close();
+        return readColumns(fullPath, columnsOffset, pointCount);
+    }
+
+    // V6/V7 chunks are checked and decoded one by one; damaged ones cost only their own points
+    if (chunked) {
+        QVector<PathChunk> chunks = readChunkTable(file, dataStart, pointCount);
+        int lostPoints = pointCount;
+        for (const PathChunk& chunk : chunks) {
+            lostPoints -= chunk.pointCount; // Beyond a damaged chunk header
+        }
+
+        int damagedPoints = 0;
+        path = readChunks(file, codecId, chunks, fromNs, toNs, damagedPoints);
+        lostPoints += damagedPoints;
+
+        if (lostPoints > 0) {
+            m_lastError = path.isEmpty()
+                          ? QString("File is corrupted: none of its chunks passed the checksum")
+                          : QString("File is damaged: %1 of %2 points failed the checksum and were skipped")
+                            .arg(lostPoints).arg(pointCount);
+            qWarning() << "Damaged path file" << filename << "-" << lostPoints << "points lost";
+        }
+
+        qDebug() << "Loaded" << path.size() << "points from" << chunks.size() << "chunks of" << filename;
+        return path;
+    }
+
+    // Read all points based on file version; timestamps become offsets from the first point.
+    // Older files are upgraded to the nanosecond model on load and written as V7 when saved
+    if (version == "MPATH_V4") {
+        // Whole blocks are decoded into place; the count was published after the last
+        // complete block, so a block cut short by a crash is never reached
+        path.resize(pointCount);
+        qint32 *x = path.writableXData();
+        qint32 *y = path.writableYData();
+        qint64 *t = path.writableTimestampData();
+
+        int decoded = 0;
+        while (decoded < pointCount) {
+            quint32 blockPoints, blockBytes;
+            stream >> blockPoints >> blockBytes;
+            if (stream.status() != QDataStream::Ok || blockPoints == 0 ||
+                blockPoints > static_cast<quint32>(pointCount - decoded) || blockBytes > file.size() - file.pos()) {
+                m_lastError = QString("Failed to read block at point %1 of %2 (File may be corrupted)").arg(decoded + 1).arg(pointCount);
+                qWarning() << "Invalid block header at point" << decoded;
+                return PathBuffer();
             }
-            path.append(point);
+
+            QByteArray block = file.read(blockBytes);
+            if (block.size() != static_cast<int>(blockBytes) ||
+                !PathCodec::decodeBlock(codecId, block, static_cast<int>(blockPoints), x + decoded, y + decoded, t + decoded)) {
+                m_lastError = QString("Failed to decode points %1-%2 of %3 (File may be corrupted)")
+                              .arg(decoded + 1).arg(decoded + blockPoints).arg(pointCount);
+                qWarning() << "Failed to decode block at point" << decoded;
+                return PathBuffer();
+            }
+            decoded += blockPoints;
         }
-    } else if (version == "MPATH_V2") {
-        // New format: points contain relative time differences
-        QDateTime baseTime = QDateTime::currentDateTime();
-        qint64 currentTimeMs = baseTime.toMSecsSinceEpoch();
+    } else if (version == "MPATH_V1") {
+        path.reserve(pointCount);
 
+        // Legacy format: points contain absolute timestamps
+        qint64 baseMs = 0;
+        qint64 currentMs = 0;
         for (int i = 0; i < pointCount; ++i) {
-            MousePoint relativePoint;
-            stream >> relativePoint;
+            QPoint position;
+            bool isRelative = false;
+            stream >> position >> isRelative;
+            if (isRelative) {
+                quint32 deltaMs;
+                stream >> deltaMs;
+                currentMs += deltaMs;
+            } else {
+                QDateTime timestamp;
+                stream >> timestamp;
+                currentMs = timestamp.toMSecsSinceEpoch();
+            }
+
             if (stream.status() != QDataStream::Ok) {
                 m_lastError = QString("Failed to read mouse point %1 of %2 (File may be corrupted)").arg(i + 1).arg(pointCount);
                 qWarning() << "Failed to read point" << i << "Stream status:" << stream.status();
                 return path;
             }
 
-            // Convert relative time to absolute timestamp for compatibility
             if (i == 0) {
-                // First point: use base time
-                MousePoint absolutePoint(relativePoint.position(), baseTime);
-                path.append(absolutePoint);
-            } else {
-                // Subsequent points: add deltaMs to previous timestamp
-                currentTimeMs += relativePoint.deltaMs();
-                QDateTime absoluteTime = QDateTime::fromMSecsSinceEpoch(currentTimeMs);
-                MousePoint absolutePoint(relativePoint.position(), absoluteTime);
-                path.append(absolutePoint);
+                baseMs = currentMs;
             }
+            path.append(position.x(), position.y(), (currentMs - baseMs) * 1000000);
+        }
+    } else {
+        // Relative formats: V2 deltas are milliseconds, V3 deltas are microseconds.
+        // The fixed-size records are read in one go and decoded without QDataStream
+        QByteArray records = file.read(static_cast<qint64>(pointCount) * MIN_POINT_RECORD_BYTES);
+        const uchar *p = reinterpret_cast<const uchar*>(records.constData());
+        const uchar *end = p + records.size();
+        path.resize(pointCount);
+        qint32 *x = path.writableXData();
+        qint32 *y = path.writableYData();
+        qint64 *t = path.writableTimestampData();
+        bool ok = version == "MPATH_V2"
+                  ? PathCodec::MillisecondRecordCodec::decode(p, end, pointCount, x, y, t)
+                  : PathCodec::MicrosecondRecordCodec::decode(p, end, pointCount, x, y, t);
+        if (!ok) {
+            m_lastError = QString("Failed to read %1 mouse points (File may be corrupted)").arg(pointCount);
+            qWarning() << "Failed to read point records from" << filename;
+            return PathBuffer();
         }
     }
 
     file.close();
 
     qDebug() << "Successfully loaded" << path.size() << "points from" << filename;
-    emit pathLoaded(filename);
+    return path;
+}
+
+// 数据块索引中记录的块数，索引缺失或校验失败时为-1
+int PathManager::indexedChunkCount(const QByteArray& index)
+{
+    if (index.size() < static_cast<int>(2 * sizeof(quint32))) {
+        return -1;
+    }
+
+    int checked = index.size() - static_cast<int>(sizeof(quint32));
+    quint32 storedCrc = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(index.constData()) + checked);
+    if (storedCrc != crc32c(index.constData(), checked)) {
+        return -1;
+    }
+    return static_cast<int>(qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(index.constData())));
+}
+
+// 读取MPATH_V6/V7的分块表：优先使用尾部索引，索引缺失或损坏时逐块扫描块头
+QVector<PathChunk> PathManager::readChunkTable(QFile& file, qint64 dataStart, int pointCount, bool *indexed)
+{
+    QVector<PathChunk> chunks;
+    if (indexed) {
+        *indexed = false;
+    }
+
+    QByteArray index = readTrailerSections(file, dataStart)
+                       .value(QByteArray(PathStreamWriter::CHUNK_INDEX_TAG, PathStreamWriter::TRAILER_TAG_SIZE));
+    if (index.size() >= static_cast<int>(2 * sizeof(quint32))) {
+        // The index ends with a CRC-32C of everything before it
+        int checked = index.size() - static_cast<int>(sizeof(quint32));
+        quint32 storedCrc = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(index.constData()) + checked);
+
+        QDataStream stream(index.left(checked));
+        stream.setVersion(QDataStream::Qt_5_15);
+        quint32 chunkCount = 0;
+        stream >> chunkCount;
+
+        qint64 nextOffset = dataStart;
+        qint64 total = 0;
+        bool valid = storedCrc == crc32c(index.constData(), checked) &&
+                     chunkCount <= static_cast<quint32>(pointCount);
+        for (quint32 i = 0; valid && i < chunkCount; ++i) {
+            PathChunk chunk;
+            quint32 chunkPoints;
+            stream >> chunk.offset >> chunkPoints >> chunk.firstNs >> chunk.lastNs;
+            chunk.pointCount = static_cast<int>(chunkPoints);
+            valid = stream.status() == QDataStream::Ok && chunkPoints > 0 &&
+                    chunk.offset >= nextOffset && chunk.offset < file.size() && chunk.firstNs <= chunk.lastNs;
+            nextOffset = chunk.offset + PathStreamWriter::CHUNK_HEADER_SIZE;
+            total += chunkPoints;
+            chunks.append(chunk);
+        }
+
+        if (valid && total == pointCount) {
+            if (indexed) {
+                *indexed = true;
+            }
+            return chunks;
+        }
+        qWarning() << "Ignoring damaged chunk index in" << file.fileName();
+        chunks.clear();
+    }
+
+    // Recording cut short (no index yet) or damaged index: follow the chunk sizes.
+    // A chunk whose header is damaged ends the walk, as its size cannot be trusted
+    qint64 offset = dataStart;
+    int remaining = pointCount;
+    while (remaining > 0 && file.seek(offset)) {
+        QByteArray header = file.read(PathStreamWriter::CHUNK_HEADER_SIZE);
+        if (header.size() != PathStreamWriter::CHUNK_HEADER_SIZE) {
+            break;
+        }
+        const uchar *h = reinterpret_cast<const uchar*>(header.constData());
+        quint32 chunkPoints = qFromBigEndian<quint32>(h);
+        quint32 chunkBytes = qFromBigEndian<quint32>(h + 4);
+        if (chunkPoints == 0 || chunkPoints > static_cast<quint32>(remaining) ||
+            chunkBytes > file.size() - offset - PathStreamWriter::CHUNK_HEADER_SIZE) {
+            break;
+        }
+
+        PathChunk chunk;
+        chunk.offset = offset;
+        chunk.pointCount = static_cast<int>(chunkPoints);
+        chunk.firstNs = std::numeric_limits<qint64>::min();
+        chunk.lastNs = std::numeric_limits<qint64>::max();
+        chunks.append(chunk);
+
+        offset += PathStreamWriter::CHUNK_HEADER_SIZE + chunkBytes;
+        remaining -= chunkPoints;
+    }
+    return chunks;
+}
+
+// 解码与时间范围重叠的数据块：顺序读取，然后在线程池上并行校验和解码
+// Every chunk is decoded straight into its own slice of one preallocated path.
+// Chunks failing their CRC (or their decode) are dropped afterwards.
+PathBuffer PathManager::readChunks(QFile& file, quint8 codecId, const QVector<PathChunk>& chunks,
+                                   qint64 fromNs, qint64 toNs, int& damagedPoints)
+{
+    struct ChunkJob
+    {
+        const PathChunk *chunk;
+        int first;        // Index of the chunk's first point in the path
+        QByteArray header;
+        QByteArray block; // Empty if the chunk could not be read
+        bool ok;
+    };
+
+    // The file is read on this thread, in order
+    QVector<ChunkJob> jobs;
+    int total = 0;
+    for (const PathChunk& chunk : chunks) {
+        if (chunk.lastNs < fromNs || chunk.firstNs > toNs) {
+            continue;
+        }
+
+        ChunkJob job;
+        job.chunk = &chunk;
+        job.first = total;
+        job.ok = false;
+        if (file.seek(chunk.offset)) {
+            job.header = file.read(PathStreamWriter::CHUNK_HEADER_SIZE);
+        }
+        if (job.header.size() == PathStreamWriter::CHUNK_HEADER_SIZE) {
+            const uchar *h = reinterpret_cast<const uchar*>(job.header.constData());
+            quint32 chunkPoints = qFromBigEndian<quint32>(h);
+            quint32 chunkBytes = qFromBigEndian<quint32>(h + 4);
+            if (chunkPoints == static_cast<quint32>(chunk.pointCount) &&
+                chunkBytes <= file.size() - chunk.offset - PathStreamWriter::CHUNK_HEADER_SIZE) {
+                job.block = file.read(chunkBytes);
+                if (job.block.size() != static_cast<int>(chunkBytes)) {
+                    job.block.clear();
+                }
+            }
+        }
+
+        jobs.append(job);
+        total += chunk.pointCount;
+    }
+
+    PathBuffer path;
+    path.resize(total);
+    qint32 *x = path.writableXData();
+    qint32 *y = path.writableYData();
+    qint64 *t = path.writableTimestampData();
+
+    // Each job touches only its own slice of the columns
+    parallelFor(jobs.size(), [&](int i) {
+        ChunkJob& job = jobs[i];
+        if (job.block.isEmpty()) {
+            return;
+        }
+        const uchar *h = reinterpret_cast<const uchar*>(job.header.constData());
+        if (qFromBigEndian<quint32>(h + 8) != crc32c(job.block.constData(), job.block.size(), crc32c(h, 8))) {
+            return;
+        }
+        job.ok = PathCodec::decodeBlock(codecId, job.block, job.chunk->pointCount,
+                                        x + job.first, y + job.first, t + job.first);
+    });
+
+    damagedPoints = 0;
+    for (const ChunkJob& job : jobs) {
+        if (!job.ok) {
+            qWarning() << "Skipping damaged chunk at offset" << job.chunk->offset << "in" << file.fileName();
+            damagedPoints += job.chunk->pointCount;
+        }
+    }
+    if (damagedPoints == 0) {
+        return path;
+    }
+
+    // Close the gaps left by damaged chunks
+    PathBuffer recovered;
+    recovered.reserve(total - damagedPoints);
+    for (const ChunkJob& job : jobs) {
+        if (job.ok) {
+            recovered.append(x + job.first, y + job.first, t + job.first, job.chunk->pointCount);
+        }
+    }
+    return recovered;
+}
+
+// 读取MPATH_V5的三列数据：小端主机上直接映射文件，不做任何解析
+PathBuffer PathManager::readColumns(const QString& fullPath, qint64 columnsOffset, int pointCount)
+{
+    const qint64 count = pointCount;
+    QSharedPointer<QFile> file(new QFile(fullPath));
+    if (!file->open(QIODevice::ReadOnly)) {
+        m_lastError = QString("Cannot open file for reading: %1").arg(file->errorString());
+        return PathBuffer();
+    }
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    // The mapping lives as long as the returned path; the offset is 8-byte aligned,
+    // so the mapped columns are aligned for their element types
+    uchar *columns = file->map(columnsOffset, count * MAPPED_POINT_BYTES);
+    if (columns) {
+        qDebug() << "Mapped" << pointCount << "points from" << fullPath;
+        return PathBuffer::fromMapping(file,
+                                       reinterpret_cast<const qint32*>(columns),
+                                       reinterpret_cast<const qint32*>(columns + count * 4),
+                                       reinterpret_cast<const qint64*>(columns + count * 8),
+                                       pointCount);
+    }
+    qWarning() << "Cannot map" << fullPath << "- reading it instead:" << file->errorString();
+#endif
+
+    // Big-endian hosts, or storage that cannot be mapped: read and convert
+    QByteArray bytes;
+    if (file->seek(columnsOffset)) {
+        bytes = file->read(count * MAPPED_POINT_BYTES);
+    }
+    if (bytes.size() != count * MAPPED_POINT_BYTES) {
+        m_lastError = QString("Failed to read %1 points (File may be corrupted)").arg(pointCount);
+        return PathBuffer();
+    }
+
+    const uchar *x = reinterpret_cast<const uchar*>(bytes.constData());
+    const uchar *y = x + count * 4;
+    const uchar *t = x + count * 8;
+    PathBuffer path;
+    path.reserve(pointCount);
+    for (int i = 0; i < pointCount; ++i) {
+        path.append(qFromLittleEndian<qint32>(x + i * 4),
+                    qFromLittleEndian<qint32>(y + i * 4),
+                    qFromLittleEndian<qint64>(t + i * 8));
+    }
     return path;
 }
 
@@ -216,7 +748,7 @@ QStringList PathManager::getAvailablePaths() const
     }
 
     QStringList filters;
-    filters << "*.mpath";
+    filters << "*.mpath" << QString("*") + SESSION_EXTENSION;
 
     QStringList files = dir.entryList(filters, QDir::Files, QDir::Time | QDir::Reversed);
     return files;
@@ -225,10 +757,7 @@ QStringList PathManager::getAvailablePaths() const
 // 删除单个路径文件
 bool PathManager::deletePath(const QString& filename)
 {
-    QString fullPath = m_dataDirectory + "/" + filename;
-    QFile file(fullPath);
-
-    if (file.exists() && file.remove()) {
+    if (removePathFile(filename)) {
         emit pathDeleted(filename);
         return true;
     }
@@ -236,6 +765,26 @@ bool PathManager::deletePath(const QString& filename)
     return false;
 }
 
+// 删除文件：会话清单连同其分段一起删除
+bool PathManager::removePathFile(const QString& filename)
+{
+    QList<SessionSegment> segments;
+    if (isSessionFile(filename)) {
+        segments = getSessionSegments(filename);
+    }
+
+    QFile file(m_dataDirectory + "/" + filename);
+    if (!file.exists() || !file.remove()) {
+        return false;
+    }
+
+    // Segments already deleted on their own are not an error
+    for (const SessionSegment& segment : segments) {
+        QFile::remove(m_dataDirectory + "/" + segment.filename);
+    }
+    return true;
+}
+
 // 批量删除多个路径文件
 bool PathManager::deletePaths(const QStringList& filenames)
 {
@@ -243,10 +792,7 @@ bool PathManager::deletePaths(const QStringList& filenames)
     QStringList failedToDelete;
 
     for (const QString& filename : filenames) {
-        QString fullPath = m_dataDirectory + "/" + filename;
-        QFile file(fullPath);
-
-        if (file.exists() && file.remove()) {
+        if (removePathFile(filename)) {
             successfullyDeleted.append(filename);
         } else {
             failedToDelete.append(filename);
@@ -274,9 +820,10 @@ bool PathManager::renamePath(const QString& oldFilename, const QString& newName)
     QString oldFullPath = m_dataDirectory + "/" + oldFilename;
     QString newFilename = newName;
 
-    // Ensure new filename has .mpath extension
-    if (!newFilename.endsWith(".mpath")) {
-        newFilename += ".mpath";
+    // Ensure new filename keeps the original extension (.mpath or .msession)
+    QString extension = isSessionFile(oldFilename) ? QString(SESSION_EXTENSION) : QString(".mpath");
+    if (!newFilename.endsWith(extension)) {
+        newFilename += extension;
     }
 
     QString newFullPath = m_dataDirectory + "/" + newFilename;
@@ -318,6 +865,10 @@ QString PathManager::getPathInfo(const QString& filename) const
         return QString();
     }
 
+    if (isSessionFile(filename)) {
+        return getSessionInfo(filename);
+    }
+
     QFile file(fullPath);
     if (!file.open(QIODevice::ReadOnly)) {
         qDebug() << "Cannot open file for path info:" << file.errorString();
@@ -333,16 +884,366 @@ QString PathManager::getPathInfo(const QString& filename) const
 
     stream >> version >> saveTime >> pointCount;
 
-    file.close();
+    QString format = version == "MPATH_V3" ? "microsecond timing" : "millisecond timing";
+    PathSummary summary;
+    if (version == "MPATH_V4" || version == "MPATH_V6" || version == "MPATH_V7") {
+        quint8 codecId = 0;
+        stream >> codecId;
+        format = QString("%1 codec, %2 timing")
+                 .arg(PathCodec::name(codecId))
+                 .arg(codecId == PathCodec::QuantizedCodec::ID ? "millisecond" : "microsecond");
+        if (version == "MPATH_V7") {
+            summary = readHeaderSummary(stream, pointCount);
+        }
+    } else if (version == "MPATH_V5") {
+        format = "memory-mapped columns, nanosecond timing";
+    }
 
-    QString info = QString("Created: %1\nPoints: %2\nSize: %3 bytes")
+    EditList edits;
+    CaptureStats stats;
+    if (summary.isValid()) {
+        // Everything else the pane shows is in the trailer, read in one pass on this file
+        QMap<QByteArray, QByteArray> sections = readTrailerSections(file, file.pos());
+        int chunkCount = indexedChunkCount(sections.value(
+            QByteArray(PathStreamWriter::CHUNK_INDEX_TAG, PathStreamWriter::TRAILER_TAG_SIZE)));
+        format += chunkCount >= 0 ? QString(", %1 chunks").arg(chunkCount) : QString(", no index");
+        edits = parseEditList(sections.value(
+            QByteArray(PathStreamWriter::EDIT_LIST_TAG, PathStreamWriter::TRAILER_TAG_SIZE)), filename);
+        stats = parseCaptureStats(sections.value(
+            QByteArray(PathStreamWriter::CAPTURE_STATS_TAG, PathStreamWriter::TRAILER_TAG_SIZE)));
+        file.close();
+    } else {
+        // Files without a header summary: the chunk table is read from the index (or chunk
+        // headers); points are not checked here
+        if ((version == "MPATH_V6" || version == "MPATH_V7") && stream.status() == QDataStream::Ok) {
+            bool indexed = false;
+            int chunkCount = readChunkTable(file, file.pos(), pointCount, &indexed).size();
+            format += QString(", %1 chunks%2").arg(chunkCount).arg(indexed ? "" : ", no index");
+        }
+        file.close();
+
+        edits = getEditList(filename);
+        stats = getCaptureStats(filename);
+    }
+
+    QString info = QString("Created: %1\nPoints: %2\nSize: %3 bytes\nFormat: %4 (%5)")
                    .arg(saveTime.toString())
                    .arg(pointCount)
-                   .arg(fileInfo.size());
+                   .arg(fileInfo.size())
+                   .arg(version)
+                   .arg(format);
+
+    if (summary.isValid()) {
+        info += "\n" + summary.summary();
+    }
+
+    if (!edits.isEmpty()) {
+        info += QString("\nEdited: %1 segments, %2 points%3")
+                .arg(edits.segments().size())
+                .arg(edits.size())
+                .arg(edits.sources().isEmpty() ? QString()
+                     : QString(" (spliced from %1)").arg(edits.sources().join(", ")));
+    }
+
+    if (stats.isValid()) {
+        info += "\n\n" + stats.summary();
+    }
 
     return info;
 }
 
+// 读取MPATH_V7文件头中编解码器编号之后的摘要块
+PathSummary PathManager::readHeaderSummary(QDataStream& stream, int pointCount)
+{
+    PathSummary summary;
+    stream >> summary;
+
+    // Count and summary are patched together; a mismatch means a checkpoint was cut short
+    if (stream.status() != QDataStream::Ok || summary.pointCount != pointCount) {
+        return PathSummary();
+    }
+    return summary;
+}
+
+// 读取文件头中的路径摘要，不读取点数据
+PathSummary PathManager::getPathSummary(const QString& filename) const
+{
+    if (isSessionFile(filename)) {
+        // Segments are joined end to end at their start offsets, as readSession() does
+        PathSummary session;
+        qint64 sessionStartNs = 0;
+        for (const SessionSegment& segment : getSessionSegments(filename)) {
+            PathSummary part = getPathSummary(segment.filename);
+            if (!part.isValid()) {
+                return PathSummary();
+            }
+            if (!session.isValid()) {
+                session.firstPoint = part.firstPoint;
+                session.bounds = part.bounds;
+                sessionStartNs = segment.startOffsetNs;
+            } else {
+                session.bounds = session.bounds.united(part.bounds);
+            }
+            session.lastPoint = part.lastPoint;
+            session.pointCount += part.pointCount;
+            session.durationNs = segment.startOffsetNs + part.durationNs - sessionStartNs;
+        }
+        return session;
+    }
+
+    QFile file(m_dataDirectory + "/" + filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return PathSummary();
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    QString version;
+    QDateTime saveTime;
+    int pointCount;
+    stream >> version >> saveTime >> pointCount;
+    if (stream.status() != QDataStream::Ok || version != "MPATH_V7") {
+        return PathSummary();
+    }
+
+    quint8 codecId;
+    stream >> codecId;
+    return readHeaderSummary(stream, pointCount);
+}
+
+// 获取会话详细信息：分段数、总点数和各分段
+QString PathManager::getSessionInfo(const QString& filename) const
+{
+    QList<SessionSegment> segments = getSessionSegments(filename);
+    if (segments.isEmpty()) {
+        return QString("Session manifest is missing or corrupted");
+    }
+
+    qint64 totalPoints = 0;
+    qint64 totalBytes = 0;
+    QString segmentList;
+    for (const SessionSegment& segment : segments) {
+        qint64 size = QFileInfo(m_dataDirectory + "/" + segment.filename).size();
+        totalPoints += segment.pointCount;
+        totalBytes += size;
+        segmentList += QString("\n  %1 (%2 points, starts at %3s)")
+                       .arg(segment.filename)
+                       .arg(segment.pointCount)
+                       .arg(QString::number(segment.startOffsetNs / 1e9, 'f', 1));
+    }
+
+    return QString("Session: %1 segments\nPoints: %2\nSize: %3 bytes\nSegments:%4")
+           .arg(segments.size())
+           .arg(totalPoints)
+           .arg(totalBytes)
+           .arg(segmentList);
+}
+
+// 读取路径文件中保存的录制质量统计
+CaptureStats PathManager::getCaptureStats(const QString& filename) const
+{
+    return parseCaptureStats(readTrailerSection(filename, PathStreamWriter::CAPTURE_STATS_TAG));
+}
+
+// 解析录制质量统计数据段
+CaptureStats PathManager::parseCaptureStats(const QByteArray& payload)
+{
+    CaptureStats stats;
+    if (payload.isEmpty()) {
+        return stats;
+    }
+
+    QDataStream statsStream(payload);
+    statsStream.setVersion(QDataStream::Qt_5_15);
+    statsStream >> stats;
+    if (statsStream.status() != QDataStream::Ok) {
+        return CaptureStats();
+    }
+    return stats;
+}
+
+// 保存编辑列表：作为新的尾部数据段追加到文件末尾，原始点数据不变
+bool PathManager::saveEditList(const QString& filename, const EditList& edits)
+{
+    m_lastError.clear();
+
+    if (isSessionFile(filename)) {
+        m_lastError = "Sessions cannot be edited; edit one of their segments instead";
+        return false;
+    }
+
+    QFile file(m_dataDirectory + "/" + filename);
+    if (!file.exists() || !file.open(QIODevice::Append)) {
+        m_lastError = QString("Cannot open file for editing: %1").arg(file.errorString());
+        return false;
+    }
+
+    QByteArray payload;
+    QDataStream payloadStream(&payload, QIODevice::WriteOnly);
+    payloadStream.setVersion(QDataStream::Qt_5_15);
+    payloadStream << edits;
+
+    // Same layout PathStreamWriter uses for trailer sections
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream.writeRawData(payload.constData(), payload.size());
+    stream << quint32(payload.size());
+    stream.writeRawData(PathStreamWriter::EDIT_LIST_TAG, PathStreamWriter::TRAILER_TAG_SIZE);
+
+    if (!file.flush() || stream.status() != QDataStream::Ok) {
+        m_lastError = QString("Failed to save edits: %1").arg(file.errorString());
+        return false;
+    }
+
+    qDebug() << "Saved edit list with" << edits.segments().size() << "segments to" << filename;
+    return true;
+}
+
+// 读取路径文件最新的编辑列表（没有编辑时为空）
+EditList PathManager::getEditList(const QString& filename) const
+{
+    if (isSessionFile(filename)) {
+        return EditList();
+    }
+    return parseEditList(readTrailerSection(filename, PathStreamWriter::EDIT_LIST_TAG), filename);
+}
+
+// 解析编辑列表数据段
+EditList PathManager::parseEditList(const QByteArray& payload, const QString& filename)
+{
+    EditList edits;
+    if (payload.isEmpty()) {
+        return edits;
+    }
+
+    QDataStream stream(payload);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream >> edits;
+    if (stream.status() != QDataStream::Ok) {
+        qWarning() << "Ignoring corrupted edit list in" << filename;
+        return EditList();
+    }
+    return edits;
+}
+
+// 加载应用了编辑列表的路径：拼接的源文件各自加载一次，样本不复制
+EditedPath PathManager::loadEditedPath(const QString& filename, const PathHandle& preloaded)
+{
+    m_lastError.clear();
+    PathHandle path = preloaded ? preloaded : loadPath(filename);
+    if (!path) {
+        return EditedPath();
+    }
+
+    EditList edits = getEditList(filename);
+    if (edits.isEmpty()) {
+        return EditedPath(path);
+    }
+
+    QVector<PathHandle> sources;
+    sources.append(path);
+    for (const QString& source : edits.sources()) {
+        PathHandle sourcePath = loadPath(source);
+        if (!sourcePath) {
+            // Its segments are dropped when the timeline is built
+            qWarning() << "Spliced path" << source << "could not be loaded:" << m_lastError;
+        }
+        sources.append(sourcePath);
+    }
+
+    EditedPath edited(sources, edits);
+    if (edited.isEmpty()) {
+        qWarning() << "Edit list of" << filename << "no longer matches its sources, playing unedited";
+        return EditedPath(path);
+    }
+    return edited;
+}
+
+// 在后台线程加载应用了编辑列表的路径
+QFuture<PathLoadResult> PathManager::loadEditedPathAsync(const QString& filename, const PathHandle& preloaded) const
+{
+    QString dataDirectory = m_dataDirectory;
+    return QtConcurrent::run([dataDirectory, filename, preloaded]() {
+        // A private manager keeps the load's error state off the caller's thread
+        PathManager loader;
+        loader.setDataDirectory(dataDirectory);
+
+        PathLoadResult result;
+        result.path = loader.loadEditedPath(filename, preloaded);
+        result.error = loader.getLastError();
+        return result;
+    });
+}
+
+// 读取路径文件中指定标签的最新尾部数据段
+QByteArray PathManager::readTrailerSection(const QString& filename, const char *tag) const
+{
+    QFile file(m_dataDirectory + "/" + filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    QString version;
+    QDateTime saveTime;
+    int pointCount;
+    stream >> version >> saveTime >> pointCount;
+    if (stream.status() != QDataStream::Ok) {
+        return QByteArray();
+    }
+
+    return readTrailerSections(file, file.pos())
+           .value(QByteArray(tag, PathStreamWriter::TRAILER_TAG_SIZE));
+}
+
+// 从文件末尾向前读取尾部数据段，遇到无效标签即停止
+QMap<QByteArray, QByteArray> PathManager::readTrailerSections(QFile& file, qint64 dataStart)
+{
+    QMap<QByteArray, QByteArray> sections;
+    const int footerSize = static_cast<int>(sizeof(quint32)) + PathStreamWriter::TRAILER_TAG_SIZE;
+
+    qint64 end = file.size();
+    while (end - footerSize >= dataStart) {
+        if (!file.seek(end - footerSize)) {
+            break;
+        }
+
+        QByteArray footer = file.read(footerSize);
+        if (footer.size() != footerSize) {
+            break;
+        }
+
+        QByteArray tag = footer.mid(sizeof(quint32));
+        if (!tag.startsWith("MP")) {
+            break;
+        }
+
+        // Payload size is a big-endian quint32, matching QDataStream
+        quint32 payloadSize = (quint8(footer[0]) << 24) | (quint8(footer[1]) << 16) |
+                              (quint8(footer[2]) << 8) | quint8(footer[3]);
+        qint64 payloadStart = end - footerSize - payloadSize;
+        if (payloadStart < dataStart || !file.seek(payloadStart)) {
+            break;
+        }
+
+        QByteArray payload = file.read(payloadSize);
+        if (payload.size() != static_cast<int>(payloadSize)) {
+            break;
+        }
+
+        // Sections are read newest first; keep the first seen for each tag
+        if (!sections.contains(tag)) {
+            sections.insert(tag, payload);
+        }
+        end = payloadStart;
+    }
+
+    return sections;
+}
+
 // 设置数据目录路径
 void PathManager::setDataDirectory(const QString& directory)
 {
@@ -359,19 +1260,35 @@ QString PathManager::dataDirectory() const
 QString PathManager::generateDateBasedFilename() const
 {
     QDateTime now = QDateTime::currentDateTime();
-    QString filename = now.toString("yyyy-MM-dd_hh-mm-ss") + ".mpath";
+    QString filename = now.toString(DATE_FILENAME_FORMAT) + ".mpath";
     return filename;
 }
 
+// 生成会话分段文件名：会话开始时间加三位序号
+QString PathManager::generateSegmentFilename(const QDateTime& sessionStart, int index) const
+{
+    return sessionStart.toString(DATE_FILENAME_FORMAT) + QString("_%1.mpath").arg(index, 3, 10, QChar('0'));
+}
+
 // 获取文件的友好显示名称：将日期格式转换为可读格式
 QString PathManager::getDisplayName(const QString& filename) const
 {
     QString baseName = QFileInfo(filename).baseName();
 
     // If it's a date-based filename, format it nicely
-    QDateTime dateTime = QDateTime::fromString(baseName, "yyyy-MM-dd_hh-mm-ss");
+    QDateTime dateTime = QDateTime::fromString(baseName, DATE_FILENAME_FORMAT);
     if (dateTime.isValid()) {
-        return dateTime.toString("yyyy-MM-dd hh:mm:ss");
+        return dateTime.toString("yyyy-MM-dd hh:mm:ss") + (isSessionFile(filename) ? " (session)" : "");
+    }
+
+    // Session segments carry a _NNN suffix after the date
+    static const QRegularExpression segmentPattern("^(.+)_(\\d{3})$");
+    QRegularExpressionMatch match = segmentPattern.match(baseName);
+    if (match.hasMatch()) {
+        dateTime = QDateTime::fromString(match.captured(1), DATE_FILENAME_FORMAT);
+        if (dateTime.isValid()) {
+            return QString("%1 (part %2)").arg(dateTime.toString("yyyy-MM-dd hh:mm:ss")).arg(match.captured(2).toInt());
+        }
     }
 
     return baseName;
@@ -0,0 +1,357 @@
+#include "pathstreamwriter.h"
+#include "crc32c.h"
+#include <QDebug>
+#include <QtEndian>
+
+const char PathStreamWriter::CAPTURE_STATS_TAG[] = "MPSTATS1";
+const char PathStreamWriter::EDIT_LIST_TAG[] = "MPEDITS1";
+const char PathStreamWriter::CHUNK_INDEX_TAG[] = "MPINDEX1";
+
+// 流式写入器构造函数
+PathStreamWriter::PathStreamWriter()
+    : m_countOffset(0)
+    , m_summaryOffset(0)
+    , m_pointCount(0)
+    , m_codec(PathCodec::DEFAULT_CODEC)
+    , m_firstTimestampNs(0)
+    , m_lastTimestampNs(0)
+{
+}
+
+PathStreamWriter::~PathStreamWriter()
+{
+    if (isOpen()) {
+        close();
+    }
+}
+
+// 设置下一个文件使用的编解码器
+void PathStreamWriter::setCodec(quint8 codecId)
+{
+    bool valid = PathCodec::isKnown(codecId) || codecId == PathCodec::MAPPED_COLUMNS;
+    m_codec = valid ? codecId : PathCodec::DEFAULT_CODEC;
+}
+
+quint8 PathStreamWriter::codec() const
+{
+    return m_codec;
+}
+
+// 打开文件并写入文件头（点数稍后回填）
+bool PathStreamWriter::open(const QString& fullPath, const QDateTime& recordedAt)
+{
+    m_error.clear();
+    m_file.setFileName(fullPath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_error = QString("Failed to open file for writing: %1").arg(m_file.errorString());
+        qWarning() << "Failed to open file for writing:" << fullPath;
+        return false;
+    }
+
+    m_stream.setDevice(&m_file);
+    m_stream.setVersion(QDataStream::Qt_5_15);
+    m_pointCount = 0;
+    m_firstTimestampNs = 0;
+    m_lastTimestampNs = 0;
+    m_summary = PathSummary();
+    m_chunks.clear();
+    m_trailerSections.clear();
+
+    // Write file header; the recording's wall-clock start is stored once here
+    bool mapped = m_codec == PathCodec::MAPPED_COLUMNS;
+    m_stream << QString(mapped ? "MPATH_V5" : "MPATH_V7");
+    m_stream << recordedAt; // Save timestamp
+    m_countOffset = m_file.pos();
+    m_stream << m_pointCount; // Number of points, patched at every checkpoint
+
+    if (mapped) {
+        // Columns start at the first 8-byte boundary after the offset field
+        qint64 columnsOffset = (m_file.pos() + sizeof(quint32) + 7) & ~qint64(7);
+        m_stream << quint32(columnsOffset);
+        QByteArray padding(static_cast<int>(columnsOffset - m_file.pos()), '\0');
+        m_stream.writeRawData(padding.constData(), padding.size());
+    } else {
+        m_stream << m_codec; // Block codec id
+        m_summaryOffset = m_file.pos();
+        m_stream << m_summary; // Patched with the count
+    }
+
+    if (m_stream.status() != QDataStream::Ok) {
+        m_error = "Failed to write file header";
+        qWarning() << "Failed to write file header, stream status:" << m_stream.status();
+        m_file.close();
+        return false;
+    }
+
+    return checkpoint();
+}
+
+// 追加一条结构数组形式的路径并建立检查点
+bool PathStreamWriter::append(const PathBuffer& points)
+{
+    if (!isOpen()) {
+        return false;
+    }
+
+    bool ok = m_codec == PathCodec::MAPPED_COLUMNS ? writeColumns(points) : writeBlocks(points);
+    return ok && checkpoint();
+}
+
+// 按块追加录制缓冲中的点（封存块逐块解码）并建立检查点
+bool PathStreamWriter::append(const SampleView& points)
+{
+    if (!isOpen()) {
+        return false;
+    }
+
+    // V5 columns need every point at once
+    if (m_codec == PathCodec::MAPPED_COLUMNS) {
+        return writeColumns(points.toPathBuffer()) && checkpoint();
+    }
+
+    // Sealed blocks are decoded one at a time, so memory stays at one block
+    QVector<MousePoint> buffer(SampleStore::BLOCK_POINTS);
+    PathBuffer block;
+    for (int i = 0; i < points.blockCount(); ++i) {
+        int count = points.readBlock(i, buffer.data());
+        block.clear();
+        block.append(buffer.constData(), count);
+        if (!writeBlocks(block)) {
+            return false;
+        }
+    }
+
+    return checkpoint();
+}
+
+// 将点编码为若干独立的数据块写入，每块带CRC-32C
+bool PathStreamWriter::writeBlocks(const PathBuffer& points)
+{
+    if (points.isEmpty()) {
+        return true;
+    }
+
+    // Timestamps are stored relative to the first point of the file
+    if (m_pointCount == 0) {
+        m_firstTimestampNs = points.timestampNs(0);
+    }
+    m_lastTimestampNs = points.timestampNs(points.size() - 1);
+    m_summary.add(points, m_firstTimestampNs);
+
+    QByteArray encoded;
+    for (int first = 0; first < points.size(); first += MAX_BLOCK_POINTS) {
+        int count = qMin(MAX_BLOCK_POINTS, points.size() - first);
+
+        encoded.clear();
+        if (!PathCodec::encodeBlock(m_codec, points, first, count, m_firstTimestampNs, encoded)) {
+            m_error = QString("Unknown path codec %1").arg(m_codec);
+            return false;
+        }
+
+        PathChunk chunk;
+        chunk.offset = m_file.pos();
+        chunk.pointCount = count;
+        chunk.firstNs = points.timestampNs(first) - m_firstTimestampNs;
+        chunk.lastNs = points.timestampNs(first + count - 1) - m_firstTimestampNs;
+
+        uchar sizes[8];
+        qToBigEndian<quint32>(count, sizes);
+        qToBigEndian<quint32>(encoded.size(), sizes + 4);
+        quint32 crc = crc32c(encoded.constData(), encoded.size(), crc32c(sizes, sizeof(sizes)));
+
+        m_stream.writeRawData(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+        m_stream << crc;
+        m_stream.writeRawData(encoded.constData(), encoded.size());
+
+        if (m_stream.status() != QDataStream::Ok) {
+            m_error = QString("Failed to write points %1-%2").arg(m_pointCount).arg(m_pointCount + count - 1);
+            qWarning() << "Failed to write block at point" << m_pointCount << "stream status:" << m_stream.status();
+            return false;
+        }
+        m_pointCount += count;
+        m_chunks.append(chunk);
+    }
+
+    return true;
+}
+
+// 写入MPATH_V5的三列数据（只能写入一次）
+bool PathStreamWriter::writeColumns(const PathBuffer& points)
+{
+    if (points.isEmpty()) {
+        return true;
+    }
+    if (m_pointCount > 0) {
+        m_error = "MPATH_V5 files take all points in a single append";
+        return false;
+    }
+
+    m_firstTimestampNs = points.timestampNs(0);
+    m_lastTimestampNs = points.timestampNs(points.size() - 1);
+
+    QVector<qint64> timestampNs(points.size());
+    const qint64 *t = points.timestampData();
+    for (int i = 0; i < points.size(); ++i) {
+        timestampNs[i] = t[i] - m_firstTimestampNs;
+    }
+
+    writeLittleEndian(points.xData(), points.size());
+    writeLittleEndian(points.yData(), points.size());
+    writeLittleEndian(timestampNs.constData(), points.size());
+
+    if (m_stream.status() != QDataStream::Ok) {
+        m_error = QString("Failed to write %1 points").arg(points.size());
+        qWarning() << "Failed to write point columns, stream status:" << m_stream.status();
+        return false;
+    }
+    m_pointCount = points.size();
+
+    return true;
+}
+
+// 按小端字节序写入一列
+template <typename T>
+void PathStreamWriter::writeLittleEndian(const T *values, int count)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    m_stream.writeRawData(reinterpret_cast<const char*>(values), count * static_cast<int>(sizeof(T)));
+#else
+    QByteArray bytes(count * static_cast<int>(sizeof(T)), Qt::Uninitialized);
+    for (int i = 0; i < count; ++i) {
+        qToLittleEndian<T>(values[i], bytes.data() + i * sizeof(T));
+    }
+    m_stream.writeRawData(bytes.constData(), bytes.size());
+#endif
+}
+
+// 关闭文件：写入最终点数和尾部数据段
+bool PathStreamWriter::close()
+{
+    if (!isOpen()) {
+        return false;
+    }
+
+    if (!m_chunks.isEmpty()) {
+        addTrailerSection(QByteArray(CHUNK_INDEX_TAG, TRAILER_TAG_SIZE), chunkIndex());
+    }
+
+    bool ok = checkpoint() && writeTrailerSections();
+    m_stream.setDevice(nullptr);
+    m_file.close();
+    return ok;
+}
+
+// 添加尾部数据段（关闭时写入）
+void PathStreamWriter::addTrailerSection(const QByteArray& tag, const QByteArray& payload)
+{
+    Q_ASSERT(tag.size() == TRAILER_TAG_SIZE && tag.startsWith("MP"));
+    m_trailerSections.append(qMakePair(tag, payload));
+}
+
+// 添加录制质量统计段
+void PathStreamWriter::setCaptureStats(const CaptureStats& stats)
+{
+    if (!stats.isValid()) {
+        return;
+    }
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_15);
+    out << stats;
+    addTrailerSection(QByteArray(CAPTURE_STATS_TAG, TRAILER_TAG_SIZE), payload);
+}
+
+bool PathStreamWriter::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+int PathStreamWriter::pointCount() const
+{
+    return m_pointCount;
+}
+
+qint64 PathStreamWriter::fileSize() const
+{
+    return m_file.size();
+}
+
+qint64 PathStreamWriter::firstTimestampNs() const
+{
+    return m_firstTimestampNs;
+}
+
+qint64 PathStreamWriter::lastTimestampNs() const
+{
+    return m_lastTimestampNs;
+}
+
+QString PathStreamWriter::filePath() const
+{
+    return m_file.fileName();
+}
+
+QString PathStreamWriter::errorString() const
+{
+    return m_error;
+}
+
+// 检查点：回填点数并把数据交给操作系统，之后文件即为完整有效的路径文件
+bool PathStreamWriter::checkpoint()
+{
+    qint64 endOffset = m_file.pos();
+
+    // Points are flushed before the count that covers them is published
+    if (!m_file.flush() || !m_file.seek(m_countOffset)) {
+        m_error = QString("Failed to checkpoint file: %1").arg(m_file.errorString());
+        return false;
+    }
+
+    m_stream << m_pointCount;
+
+    // V7 publishes the summary with the count; readers ignore a summary whose
+    // point count disagrees with the header's
+    bool summaryOk = m_codec == PathCodec::MAPPED_COLUMNS || m_file.seek(m_summaryOffset);
+    if (m_codec != PathCodec::MAPPED_COLUMNS && summaryOk) {
+        m_stream << m_summary;
+    }
+
+    if (!summaryOk || !m_file.flush() || !m_file.seek(endOffset) || m_stream.status() != QDataStream::Ok) {
+        m_error = QString("Failed to checkpoint file: %1").arg(m_file.errorString());
+        return false;
+    }
+
+    return true;
+}
+
+// 在点数据之后写入尾部数据段
+bool PathStreamWriter::writeTrailerSections()
+{
+    for (const auto& section : m_trailerSections) {
+        m_stream.writeRawData(section.second.constData(), section.second.size());
+        m_stream << quint32(section.second.size());
+        m_stream.writeRawData(section.first.constData(), TRAILER_TAG_SIZE);
+    }
+    m_trailerSections.clear();
+
+    if (!m_file.flush() || m_stream.status() != QDataStream::Ok) {
+        m_error = QString("Failed to write trailer sections: %1").arg(m_file.errorString());
+        return false;
+    }
+    return true;
+}
+
+// 分块索引：块数、每块的偏移、点数和时间范围，最后是索引本身的CRC-32C
+QByteArray PathStreamWriter::chunkIndex() const
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_15);
+    out << quint32(m_chunks.size());
+    for (const PathChunk& chunk : m_chunks) {
+        out << chunk.offset << quint32(chunk.pointCount) << chunk.firstNs << chunk.lastNs;
+    }
+    out << crc32c(payload.constData(), payload.size());
+    return payload;
+}
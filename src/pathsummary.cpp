@@ -0,0 +1,101 @@
+#include "pathsummary.h"
+
+// 空摘要
+PathSummary::PathSummary()
+    : pointCount(0)
+    , durationNs(0)
+{
+}
+
+bool PathSummary::isValid() const
+{
+    return pointCount > 0;
+}
+
+// 累加一批点：更新首末点、外接矩形和时长
+void PathSummary::add(const PathBuffer& points, qint64 originNs)
+{
+    if (points.isEmpty()) {
+        return;
+    }
+
+    QRect added = points.bounds();
+    if (pointCount == 0) {
+        firstPoint = points.position(0);
+        bounds = added;
+    } else {
+        bounds = bounds.united(added);
+    }
+
+    lastPoint = points.position(points.size() - 1);
+    durationNs = points.timestampNs(points.size() - 1) - originNs;
+    pointCount += points.size();
+}
+
+// 从已加载的路径计算摘要（文件头中没有摘要时使用）
+PathSummary PathSummary::fromPath(const PathBuffer& path)
+{
+    PathSummary summary;
+    if (!path.isEmpty()) {
+        summary.add(path, path.timestampNs(0));
+    }
+    return summary;
+}
+
+double PathSummary::averageRateHz() const
+{
+    return pointCount > 1 && durationNs > 0 ? (pointCount - 1) * 1e9 / durationNs : 0.0;
+}
+
+// 格式化摘要
+QString PathSummary::summary() const
+{
+    return QString("Duration: %1 s\n"
+                   "Bounds: (%2, %3) - (%4, %5)\n"
+                   "First Point: (%6, %7)\n"
+                   "Last Point: (%8, %9)\n"
+                   "Average Rate: %10 Hz")
+           .arg(QString::number(durationNs / 1e9, 'f', 3))
+           .arg(bounds.left()).arg(bounds.top()).arg(bounds.right()).arg(bounds.bottom())
+           .arg(firstPoint.x()).arg(firstPoint.y())
+           .arg(lastPoint.x()).arg(lastPoint.y())
+           .arg(QString::number(averageRateHz(), 'f', 1));
+}
+
+QDataStream& operator<<(QDataStream& stream, const PathSummary& summary)
+{
+    stream << quint32(PathSummary::FIELDS_SIZE)
+           << qint32(summary.pointCount)
+           << summary.durationNs
+           << qint32(summary.bounds.left()) << qint32(summary.bounds.top())
+           << qint32(summary.bounds.right()) << qint32(summary.bounds.bottom())
+           << qint32(summary.firstPoint.x()) << qint32(summary.firstPoint.y())
+           << qint32(summary.lastPoint.x()) << qint32(summary.lastPoint.y());
+    return stream;
+}
+
+QDataStream& operator>>(QDataStream& stream, PathSummary& summary)
+{
+    summary = PathSummary();
+
+    quint32 size;
+    stream >> size;
+    // A block is a few dozen bytes; anything much larger is not a summary
+    if (stream.status() != QDataStream::Ok || size < static_cast<quint32>(PathSummary::FIELDS_SIZE) || size > 0xFFFF) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+        return stream;
+    }
+
+    qint32 pointCount, left, top, right, bottom, firstX, firstY, lastX, lastY;
+    stream >> pointCount >> summary.durationNs
+           >> left >> top >> right >> bottom
+           >> firstX >> firstY >> lastX >> lastY;
+    summary.pointCount = pointCount;
+    summary.bounds = QRect(QPoint(left, top), QPoint(right, bottom));
+    summary.firstPoint = QPoint(firstX, firstY);
+    summary.lastPoint = QPoint(lastX, lastY);
+
+    // Fields added by later versions
+    stream.skipRawData(static_cast<int>(size) - PathSummary::FIELDS_SIZE);
+    return stream;
+}
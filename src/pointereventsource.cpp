@@ -0,0 +1,341 @@
+#include "pointereventsource.h"
+#include <QThread>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+
+#ifdef HAVE_XINPUT2
+// X11 headers define macros such as None/Bool/Status, so include them after Qt
+#include <X11/Xlib.h>
+#include <X11/extensions/XInput2.h>
+#include <poll.h>
+#endif
+
+// 指针事件源构造函数
+PointerEventSource::PointerEventSource(QObject *parent)
+    : QObject(parent)
+    , m_queue(nullptr)
+{
+}
+
+PointerEventSource::~PointerEventSource()
+{
+}
+
+// 创建当前平台可用的原生事件源
+PointerEventSource* PointerEventSource::createNative(QObject *parent)
+{
+    if (XInput2PointerSource::isSupported()) {
+        return new XInput2PointerSource(parent);
+    }
+    return nullptr;
+}
+
+// 检查当前平台是否支持原生指针事件
+bool PointerEventSource::isNativeSupported()
+{
+    return XInput2PointerSource::isSupported();
+}
+
+// 设置样本队列：事件直接写入无锁队列
+void PointerEventSource::setSampleQueue(CaptureQueue *queue)
+{
+    m_queue = queue;
+}
+
+// 发布一个指针事件：写入队列或发出信号
+void PointerEventSource::publish(const QPoint& position, qint64 timestampNs)
+{
+    CaptureQueue *queue = m_queue.load();
+    if (queue) {
+        CaptureSample sample;
+        sample.position = position;
+        sample.timestampNs = timestampNs;
+        sample.deadlineNs = 0;
+        sample.missedTicks = 0;
+        queue->push(sample);
+    } else {
+        emit pointerMoved(position, timestampNs);
+    }
+}
+
+// XInput2事件源构造函数
+XInput2PointerSource::XInput2PointerSource(QObject *parent)
+    : PointerEventSource(parent)
+    , m_thread(nullptr)
+    , m_stopRequested(false)
+#ifdef HAVE_XINPUT2
+    , m_display(nullptr)
+    , m_opcode(0)
+#endif
+{
+}
+
+XInput2PointerSource::~XInput2PointerSource()
+{
+    stop();
+}
+
+// 检查X服务器是否提供XInput 2.0扩展
+bool XInput2PointerSource::isSupported()
+{
+#ifdef HAVE_XINPUT2
+    static int supported = -1;
+    if (supported < 0) {
+        supported = 0;
+        Display *display = XOpenDisplay(nullptr);
+        if (display) {
+            int opcode, event, error;
+            int major = 2, minor = 0;
+            if (XQueryExtension(display, "XInputExtension", &opcode, &event, &error) &&
+                XIQueryVersion(display, &major, &minor) == Success) {
+                supported = 1;
+            }
+            XCloseDisplay(display);
+        }
+    }
+    return supported == 1;
+#else
+    return false;
+#endif
+}
+
+// 启动事件监听线程：显示连接和事件订阅在此同步完成，失败时返回false以便回退到轮询
+bool XInput2PointerSource::start()
+{
+    if (m_thread) {
+        return true;
+    }
+
+#ifdef HAVE_XINPUT2
+    // Use a private connection so the event thread never touches Qt's xcb connection
+    Display *display = XOpenDisplay(nullptr);
+    if (!display) {
+        emit sourceError("Failed to open X display for pointer events");
+        return false;
+    }
+
+    int opcode, event, error;
+    int major = 2, minor = 0;
+    if (!XQueryExtension(display, "XInputExtension", &opcode, &event, &error) ||
+        XIQueryVersion(display, &major, &minor) != Success) {
+        emit sourceError("XInput2 is not available on this display");
+        XCloseDisplay(display);
+        return false;
+    }
+
+    // Raw events are delivered regardless of which window the pointer is over
+    unsigned char maskBits[XIMaskLen(XI_LASTEVENT)] = {0};
+    XISetMask(maskBits, XI_RawMotion);
+
+    XIEventMask mask;
+    mask.deviceid = XIAllMasterDevices;
+    mask.mask_len = sizeof(maskBits);
+    mask.mask = maskBits;
+    if (XISelectEvents(display, DefaultRootWindow(display), &mask, 1) != Success) {
+        emit sourceError("Failed to select XInput2 raw motion events");
+        XCloseDisplay(display);
+        return false;
+    }
+    XSync(display, False);
+
+    m_display = display;
+    m_opcode = opcode;
+    m_stopRequested = false;
+    m_thread = QThread::create([this]() { eventLoop(); });
+    m_thread->setObjectName("XInput2PointerSource");
+    m_thread->start(QThread::TimeCriticalPriority);
+    return true;
+#else
+    emit sourceError("XInput2 is not available on this display");
+    return false;
+#endif
+}
+
+// 停止事件监听线程并等待退出
+void XInput2PointerSource::stop()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    m_stopRequested = true;
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+
+#ifdef HAVE_XINPUT2
+    XCloseDisplay(m_display);
+    m_display = nullptr;
+#endif
+}
+
+bool XInput2PointerSource::isRunning() const
+{
+    return m_thread != nullptr;
+}
+
+QString XInput2PointerSource::name() const
+{
+    return "XInput2 raw motion";
+}
+
+// 事件循环：读取start()中订阅的根窗口原始运动事件
+void XInput2PointerSource::eventLoop()
+{
+#ifdef HAVE_XINPUT2
+    // The connection is used only by this thread until stop() has joined it
+    Display *display = m_display;
+    int opcode = m_opcode;
+    Window root = DefaultRootWindow(display);
+
+    pollfd fd;
+    fd.fd = ConnectionNumber(display);
+    fd.events = POLLIN;
+
+    while (!m_stopRequested) {
+        // Wake up periodically so stop() never blocks on an idle pointer
+        if (XPending(display) == 0 && poll(&fd, 1, 50) <= 0) {
+            continue;
+        }
+
+        while (XPending(display) > 0) {
+            XEvent ev;
+            XNextEvent(display, &ev);
+
+            XGenericEventCookie *cookie = &ev.xcookie;
+            if (cookie->type != GenericEvent || cookie->extension != opcode) {
+                continue;
+            }
+
+            if (XGetEventData(display, cookie)) {
+                if (cookie->evtype == XI_RawMotion) {
+                    // Raw events carry device deltas, so read back the accelerated cursor position
+                    Window rootReturn, childReturn;
+                    int rootX, rootY, winX, winY;
+                    unsigned int buttons;
+                    if (XQueryPointer(display, root, &rootReturn, &childReturn,
+                                      &rootX, &rootY, &winX, &winY, &buttons)) {
+                        publish(QPoint(rootX, rootY), CaptureThread::monotonicNowNs());
+                    }
+                }
+                XFreeEventData(display, cookie);
+            }
+        }
+    }
+#endif
+}
+
+// 事件日志回放源构造函数
+EventLogPointerSource::EventLogPointerSource(QObject *parent)
+    : PointerEventSource(parent)
+    , m_replayTimer(new QTimer(this))
+    , m_startNs(0)
+    , m_nextEvent(0)
+    , m_running(false)
+{
+    m_replayTimer->setSingleShot(true);
+    m_replayTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_replayTimer, &QTimer::timeout, this, &EventLogPointerSource::emitDueEvents);
+}
+
+// 加载事件日志文件
+bool EventLogPointerSource::loadLog(const QString& filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Failed to open pointer event log:" << filename;
+        return false;
+    }
+
+    m_events.clear();
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        QStringList fields = line.split(' ', Qt::SkipEmptyParts);
+        bool okTime, okX, okY;
+        if (fields.size() != 3) {
+            qWarning() << "Skipping malformed event log line:" << line;
+            continue;
+        }
+
+        LoggedEvent event;
+        event.offsetUs = fields[0].toLongLong(&okTime);
+        event.position = QPoint(fields[1].toInt(&okX), fields[2].toInt(&okY));
+        if (!okTime || !okX || !okY) {
+            qWarning() << "Skipping malformed event log line:" << line;
+            continue;
+        }
+        m_events.append(event);
+    }
+
+    return !m_events.isEmpty();
+}
+
+int EventLogPointerSource::eventCount() const
+{
+    return m_events.size();
+}
+
+// 开始回放日志事件
+bool EventLogPointerSource::start()
+{
+    if (m_running) {
+        return true;
+    }
+    if (m_events.isEmpty()) {
+        emit sourceError("Pointer event log is empty");
+        return false;
+    }
+
+    m_running = true;
+    m_nextEvent = 0;
+    m_startNs = CaptureThread::monotonicNowNs();
+    m_replayClock.start();
+    emitDueEvents();
+    return true;
+}
+
+// 停止回放
+void EventLogPointerSource::stop()
+{
+    m_replayTimer->stop();
+    m_running = false;
+}
+
+bool EventLogPointerSource::isRunning() const
+{
+    return m_running;
+}
+
+QString EventLogPointerSource::name() const
+{
+    return "Event log replay";
+}
+
+// 发出所有已到期的日志事件，并调度下一个事件
+void EventLogPointerSource::emitDueEvents()
+{
+    if (!m_running) {
+        return;
+    }
+
+    qint64 elapsedUs = m_replayClock.nsecsElapsed() / 1000;
+    while (m_nextEvent < m_events.size() && m_events[m_nextEvent].offsetUs <= elapsedUs) {
+        const LoggedEvent& event = m_events[m_nextEvent];
+        // Logged offsets are used as the event time so replays are deterministic
+        publish(event.position, m_startNs + event.offsetUs * 1000);
+        m_nextEvent++;
+    }
+
+    if (m_nextEvent < m_events.size()) {
+        qint64 waitUs = m_events[m_nextEvent].offsetUs - elapsedUs;
+        m_replayTimer->start(static_cast<int>(qMax(0LL, waitUs / 1000)));
+    } else {
+        m_running = false;
+    }
+}
@@ -0,0 +1,314 @@
+#include "samplestore.h"
+#include "pathcodec.h"
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+// 空视图
+SampleView::SampleView()
+    : m_store(nullptr)
+{
+}
+
+// 基于录制缓冲的视图
+SampleView::SampleView(const SampleStore *store)
+    : m_store(store)
+{
+}
+
+int SampleView::size() const
+{
+    return m_store ? m_store->size() : 0;
+}
+
+bool SampleView::isEmpty() const
+{
+    return size() == 0;
+}
+
+const MousePoint& SampleView::at(int index) const
+{
+    return m_store->at(index);
+}
+
+const MousePoint& SampleView::first() const
+{
+    return m_store->at(0);
+}
+
+const MousePoint& SampleView::last() const
+{
+    return m_store->last();
+}
+
+int SampleView::blockCount() const
+{
+    return m_store ? m_store->blockCount() : 0;
+}
+
+int SampleView::blockSize(int block) const
+{
+    return m_store->blockSize(block);
+}
+
+int SampleView::readBlock(int block, MousePoint *out) const
+{
+    return m_store->readBlock(block, out);
+}
+
+// 解码为独立的结构数组路径
+PathBuffer SampleView::toPathBuffer() const
+{
+    PathBuffer path;
+    path.reserve(size());
+
+    QVector<MousePoint> buffer(SampleStore::BLOCK_POINTS);
+    for (int block = 0; block < blockCount(); ++block) {
+        int count = readBlock(block, buffer.data());
+        path.append(buffer.constData(), count);
+    }
+    return path;
+}
+
+const qint64 SampleStore::FIXED_BYTES = 2 * BLOCK_POINTS * static_cast<qint64>(sizeof(MousePoint)) +
+                                        MAX_ENCODED_BLOCK_BYTES +
+                                        TABLE_PAGES * static_cast<qint64>(sizeof(void*));
+
+// 录制缓冲构造函数：预分配两个原始块、编码缓冲和块表目录
+SampleStore::SampleStore()
+    : m_table(new std::unique_ptr<QByteArray[]>[TABLE_PAGES])
+    , m_sealedCount(0)
+    , m_active(new MousePoint[BLOCK_POINTS])
+    , m_activeCount(0)
+    , m_sealedBytes(0)
+    , m_tablePages(0)
+    , m_pending(new MousePoint[BLOCK_POINTS])
+    , m_pendingEncoded(-1)
+    , m_pendingStep(0)
+    , m_cacheBlock(-1)
+{
+    // Appending within the reserved capacity never reallocates
+    m_scratch.reserve(MAX_ENCODED_BLOCK_BYTES);
+}
+
+// 追加一个点：当前块已满时与空闲块交换，并逐步编码待封存的块
+void SampleStore::append(const MousePoint& point)
+{
+    if (m_activeCount == BLOCK_POINTS) {
+        // Only reachable if a caller filled a block faster than it could be encoded
+        if (m_pendingEncoded >= 0) {
+            encodePending(BLOCK_POINTS);
+        }
+        std::swap(m_active, m_pending);
+        m_activeCount = 0;
+        m_pendingEncoded = 0;
+        m_pendingStep = 0;
+        m_scratch.resize(0);
+    }
+    m_active[m_activeCount++] = point;
+
+    if (m_pendingEncoded >= 0) {
+        encodePending(ENCODE_POINTS_PER_APPEND);
+    }
+}
+
+// 清空数据，预分配的缓冲和第一页块表保留供下一次录制使用
+void SampleStore::clear()
+{
+    for (int page = 0; page < TABLE_PAGES && m_table[page]; ++page) {
+        if (page == 0) {
+            for (int i = 0; i < qMin(m_sealedCount, TABLE_PAGE_BLOCKS); ++i) {
+                m_table[0][i] = QByteArray();
+            }
+        } else {
+            m_table[page].reset();
+        }
+    }
+    m_sealedCount = 0;
+    m_activeCount = 0;
+    m_pendingEncoded = -1;
+    m_scratch.resize(0);
+    m_sealedBytes = 0;
+    m_tablePages = qMin(m_tablePages, 1);
+    m_cacheBlock = -1;
+}
+
+int SampleStore::size() const
+{
+    return blockCount() == 0 ? 0 : (blockCount() - 1) * BLOCK_POINTS + blockSize(blockCount() - 1);
+}
+
+bool SampleStore::isEmpty() const
+{
+    return size() == 0;
+}
+
+// 随机访问：封存块解码到缓存中
+const MousePoint& SampleStore::at(int index) const
+{
+    Q_ASSERT(index >= 0 && index < size());
+
+    int block = index / BLOCK_POINTS;
+    if (block >= m_sealedCount) {
+        const MousePoint *raw = block == m_sealedCount && m_pendingEncoded >= 0 ? m_pending.get() : m_active.get();
+        return raw[index % BLOCK_POINTS];
+    }
+
+    if (m_cacheBlock != block) {
+        m_cache.resize(BLOCK_POINTS);
+        if (decodeBlock(sealedBlock(block), m_cache.data(), BLOCK_POINTS) != BLOCK_POINTS) {
+            qWarning() << "Sealed sample block" << block << "is damaged";
+        }
+        m_cacheBlock = block;
+    }
+    return m_cache[index % BLOCK_POINTS];
+}
+
+const MousePoint& SampleStore::last() const
+{
+    return at(size() - 1);
+}
+
+int SampleStore::blockCount() const
+{
+    return m_sealedCount + (m_pendingEncoded >= 0 ? 1 : 0) + (m_activeCount > 0 ? 1 : 0);
+}
+
+// 指定块中的点数（只有当前块可能不满）
+int SampleStore::blockSize(int block) const
+{
+    return block < blockCount() - 1 || m_activeCount == 0 ? BLOCK_POINTS : m_activeCount;
+}
+
+// 将一个块读出到调用者的缓冲区，返回点数
+int SampleStore::readBlock(int block, MousePoint *out) const
+{
+    if (block < m_sealedCount) {
+        int decoded = decodeBlock(sealedBlock(block), out, BLOCK_POINTS);
+        if (decoded != BLOCK_POINTS) {
+            qWarning() << "Sealed sample block" << block << "is damaged; kept" << decoded << "points";
+        }
+        return decoded;
+    }
+
+    if (block == m_sealedCount && m_pendingEncoded >= 0) {
+        std::copy(m_pending.get(), m_pending.get() + BLOCK_POINTS, out);
+        return BLOCK_POINTS;
+    }
+
+    std::copy(m_active.get(), m_active.get() + m_activeCount, out);
+    return m_activeCount;
+}
+
+// 点数据占用的堆内存估计
+qint64 SampleStore::memoryBytes() const
+{
+    qint64 pageBytes = TABLE_PAGE_BLOCKS * static_cast<qint64>(sizeof(QByteArray)) + HEAP_CHUNK_OVERHEAD;
+    return m_sealedBytes + m_tablePages * pageBytes + FIXED_BYTES;
+}
+
+// 封存块中每个点的字节数
+double SampleStore::bytesPerSealedPoint() const
+{
+    if (m_sealedCount == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(m_sealedBytes) / (static_cast<qint64>(m_sealedCount) * BLOCK_POINTS);
+}
+
+SampleView SampleStore::view() const
+{
+    return SampleView(this);
+}
+
+// 块表中的封存块：页在第一次使用时分配，之后位置不变
+QByteArray& SampleStore::sealedBlock(int block)
+{
+    std::unique_ptr<QByteArray[]>& page = m_table[block / TABLE_PAGE_BLOCKS];
+    if (!page) {
+        page.reset(new QByteArray[TABLE_PAGE_BLOCKS]);
+        ++m_tablePages;
+    }
+    return page[block % TABLE_PAGE_BLOCKS];
+}
+
+const QByteArray& SampleStore::sealedBlock(int block) const
+{
+    return m_table[block / TABLE_PAGE_BLOCKS][block % TABLE_PAGE_BLOCKS];
+}
+
+// 差分编码待封存块的下一批点：首点原样存储，之后每点为dx、dy和时间步长变化量的zigzag变长整数
+void SampleStore::encodePending(int count)
+{
+    const MousePoint *points = m_pending.get();
+    int end = qMin(BLOCK_POINTS, m_pendingEncoded + count);
+
+    if (m_pendingEncoded == 0) {
+        qint32 x = points[0].position().x();
+        qint32 y = points[0].position().y();
+        qint64 t = points[0].timestampNs();
+        m_scratch.append(reinterpret_cast<const char*>(&x), sizeof(x));
+        m_scratch.append(reinterpret_cast<const char*>(&y), sizeof(y));
+        m_scratch.append(reinterpret_cast<const char*>(&t), sizeof(t));
+        m_pendingEncoded = 1;
+    }
+
+    for (int i = m_pendingEncoded; i < end; ++i) {
+        const MousePoint& previous = points[i - 1];
+        const MousePoint& current = points[i];
+        qint64 step = current.timestampNs() - previous.timestampNs();
+        qint64 dx = static_cast<qint64>(current.position().x()) - previous.position().x();
+        qint64 dy = static_cast<qint64>(current.position().y()) - previous.position().y();
+        PathCodec::putVarint(m_scratch, PathCodec::zigzag(dx));
+        PathCodec::putVarint(m_scratch, PathCodec::zigzag(dy));
+        // Fixed-rate capture keeps the step nearly constant, so its change is small
+        PathCodec::putVarint(m_scratch, PathCodec::zigzag(step - m_pendingStep));
+        m_pendingStep = step;
+    }
+    m_pendingEncoded = qMax(m_pendingEncoded, end);
+
+    if (m_pendingEncoded == BLOCK_POINTS) {
+        // Exact-size copy; the scratch keeps its capacity for the next block
+        QByteArray& sealed = sealedBlock(m_sealedCount++);
+        sealed = QByteArray(m_scratch.constData(), m_scratch.size());
+        // Payload plus terminator, the QByteArray data header and the allocator's own header
+        m_sealedBytes += sealed.capacity() + 1 + static_cast<qint64>(sizeof(QArrayData)) + HEAP_CHUNK_OVERHEAD;
+        m_pendingEncoded = -1;
+    }
+}
+
+// 解码封存块，返回解码出的点数；损坏的块在出错处截止，其余输出重复最后一个有效点
+int SampleStore::decodeBlock(const QByteArray& data, MousePoint *out, int count)
+{
+    const uchar *p = reinterpret_cast<const uchar*>(data.constData());
+    const uchar *end = p + data.size();
+
+    int decoded = 0;
+    if (end - p >= 16) {
+        qint32 x, y;
+        qint64 t;
+        std::memcpy(&x, p, sizeof(x));
+        std::memcpy(&y, p + 4, sizeof(y));
+        std::memcpy(&t, p + 8, sizeof(t));
+        p += 16;
+        out[decoded++] = MousePoint(x, y, t);
+
+        qint64 step = 0;
+        quint64 dx, dy, dstep;
+        while (decoded < count && PathCodec::getVarint(p, end, dx) &&
+               PathCodec::getVarint(p, end, dy) && PathCodec::getVarint(p, end, dstep)) {
+            // Deltas were taken in 64 bits; wrapping back to 32 restores the coordinate
+            x = static_cast<qint32>(static_cast<quint32>(x) + static_cast<quint32>(PathCodec::unzigzag(dx)));
+            y = static_cast<qint32>(static_cast<quint32>(y) + static_cast<quint32>(PathCodec::unzigzag(dy)));
+            step += PathCodec::unzigzag(dstep);
+            t += step;
+            out[decoded++] = MousePoint(x, y, t);
+        }
+    }
+
+    if (decoded < count) {
+        MousePoint filler = decoded > 0 ? out[decoded - 1] : MousePoint();
+        std::fill(out + decoded, out + count, filler);
+    }
+    return decoded;
+}
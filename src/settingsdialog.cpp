@@ -1,7 +1,14 @@
 #include "settingsdialog.h"
+#include "mouserecorder.h"
+#include "pointereventsource.h"
+#include "pathcodec.h"
 #include <QKeySequence>
+#include <QStandardItemModel>
 #include <QMessageBox>
 #include <QTimer>
+#include <QApplication>
+#include <QFutureWatcher>
+#include <QtConcurrent>
 
 // 设置对话框构造函数：初始化设置存储和验证定时器
 SettingsDialog::SettingsDialog(QWidget *parent)
@@ -22,7 +29,7 @@ void SettingsDialog::setupUI()
 {
     setWindowTitle("Settings");
     setModal(true);
-    setFixedSize(400, 300);
+    setFixedSize(400, 720);
 
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
 
@@ -34,6 +41,10 @@ void SettingsDialog::setupUI()
     m_hotkeyEdit->setToolTip("Press the key combination you want to use for recording");
     hotkeyLayout->addRow("Recording Hotkey:", m_hotkeyEdit);
 
+    m_flightHotkeyEdit = new QKeySequenceEdit();
+    m_flightHotkeyEdit->setToolTip("Save the flight recorder pre-roll and keep recording");
+    hotkeyLayout->addRow("Flight Recorder Hotkey:", m_flightHotkeyEdit);
+
     // Recording settings group
     QGroupBox *recordingGroup = new QGroupBox("Recording Settings");
     QFormLayout *recordingLayout = new QFormLayout(recordingGroup);
@@ -44,6 +55,112 @@ void SettingsDialog::setupUI()
     m_intervalSpinBox->setToolTip("Interval between recorded mouse positions\n1-9ms: Ultra-precise (may consume high CPU)\n10-49ms: High precision\n50-100ms: Balanced (recommended)\n100+ms: Low precision");
     recordingLayout->addRow("Recording Interval:", m_intervalSpinBox);
 
+    // Calibration: measure this machine and pick the lowest interval within budget
+    m_cpuBudgetSpinBox = new QDoubleSpinBox();
+    m_cpuBudgetSpinBox->setRange(0.1, 50.0);
+    m_cpuBudgetSpinBox->setSingleStep(0.5);
+    m_cpuBudgetSpinBox->setSuffix(" % CPU");
+    m_cpuBudgetSpinBox->setToolTip("Highest CPU usage the capture thread may cost");
+
+    m_jitterBoundSpinBox = new QSpinBox();
+    m_jitterBoundSpinBox->setRange(5, 200);
+    m_jitterBoundSpinBox->setSuffix(" % jitter");
+    m_jitterBoundSpinBox->setToolTip("Largest allowed deviation of the p99 interval from the target");
+
+    m_calibrateButton = new QPushButton("Calibrate");
+    m_calibrateButton->setToolTip("Measure timer resolution, capture cost and achieved rate,\nthen select the lowest interval within the budget");
+
+    QHBoxLayout *calibrationLayout = new QHBoxLayout();
+    calibrationLayout->addWidget(m_cpuBudgetSpinBox);
+    calibrationLayout->addWidget(m_jitterBoundSpinBox);
+    calibrationLayout->addWidget(m_calibrateButton);
+    recordingLayout->addRow("Calibration:", calibrationLayout);
+
+    m_calibrationLabel = new QLabel();
+    m_calibrationLabel->setStyleSheet("color: #666666; font-style: italic;");
+    m_calibrationLabel->setWordWrap(true);
+    recordingLayout->addRow("", m_calibrationLabel);
+
+    m_captureModeComboBox = new QComboBox();
+    m_captureModeComboBox->addItem("Timer polling", MouseRecorder::PollingCapture);
+    m_captureModeComboBox->addItem("Pointer events (XInput2)", MouseRecorder::EventCapture);
+    m_captureModeComboBox->setToolTip("Timer polling: sample the cursor every recording interval\nPointer events: record one point per real mouse motion event");
+    if (!PointerEventSource::isNativeSupported()) {
+        // Keep the entry visible but disabled so users know the mode exists
+        QStandardItemModel *model = qobject_cast<QStandardItemModel*>(m_captureModeComboBox->model());
+        if (model) {
+            model->item(1)->setEnabled(false);
+        }
+    }
+    recordingLayout->addRow("Capture Mode:", m_captureModeComboBox);
+
+    m_adaptiveRateCheckBox = new QCheckBox();
+    m_adaptiveRateCheckBox->setToolTip("Timer polling only: sample every 100ms while the cursor is idle\nand return to the recording interval as soon as it moves.");
+    recordingLayout->addRow("Adaptive Rate:", m_adaptiveRateCheckBox);
+
+    m_velocityBoostCheckBox = new QCheckBox();
+    m_velocityBoostCheckBox->setToolTip("Sample at a quarter of the recording interval during fast strokes");
+    recordingLayout->addRow("Fast Stroke Boost:", m_velocityBoostCheckBox);
+
+    m_streamToDiskCheckBox = new QCheckBox();
+    m_streamToDiskCheckBox->setToolTip("Write the recording to disk block by block while recording.\nRemoves the in-memory point limit; a crash loses at most the last few seconds.");
+    recordingLayout->addRow("Stream to Disk:", m_streamToDiskCheckBox);
+
+    m_segmentSizeSpinBox = new QSpinBox();
+    m_segmentSizeSpinBox->setRange(0, 4096);
+    m_segmentSizeSpinBox->setSuffix(" MB");
+    m_segmentSizeSpinBox->setSpecialValueText("Off");
+    m_segmentSizeSpinBox->setToolTip("Start a new segment file when the current one reaches this size");
+
+    m_segmentPointsSpinBox = new QSpinBox();
+    m_segmentPointsSpinBox->setRange(0, 100000000);
+    m_segmentPointsSpinBox->setSingleStep(100000);
+    m_segmentPointsSpinBox->setSuffix(" pts");
+    m_segmentPointsSpinBox->setSpecialValueText("Off");
+    m_segmentPointsSpinBox->setToolTip("Start a new segment file after this many points");
+
+    m_segmentMinutesSpinBox = new QSpinBox();
+    m_segmentMinutesSpinBox->setRange(0, 1440);
+    m_segmentMinutesSpinBox->setSuffix(" min");
+    m_segmentMinutesSpinBox->setSpecialValueText("Off");
+    m_segmentMinutesSpinBox->setToolTip("Start a new segment file after this much recorded time");
+
+    QHBoxLayout *segmentLayout = new QHBoxLayout();
+    segmentLayout->addWidget(m_segmentSizeSpinBox);
+    segmentLayout->addWidget(m_segmentPointsSpinBox);
+    segmentLayout->addWidget(m_segmentMinutesSpinBox);
+    recordingLayout->addRow("Split Segments:", segmentLayout);
+
+    m_pathCodecComboBox = new QComboBox();
+    m_pathCodecComboBox->addItem("Delta run-length (smallest, fastest decoding)", PathCodec::DeltaRunLengthCodec::ID);
+    m_pathCodecComboBox->addItem("Delta varint (compact, lossless)", PathCodec::DeltaVarintCodec::ID);
+    m_pathCodecComboBox->addItem("Fixed width (largest, simplest)", PathCodec::FixedWidthCodec::ID);
+    m_pathCodecComboBox->addItem("Quantized (compact, 1 ms timing)", PathCodec::QuantizedCodec::ID);
+    m_pathCodecComboBox->addItem("Uncompressed columns (instant loading)", PathCodec::MAPPED_COLUMNS);
+    m_pathCodecComboBox->setToolTip("How points are encoded in newly saved files.\nFiles already saved keep their codec and always load.\n"
+                                    "Uncompressed files are memory-mapped on load; streamed recordings use delta run-length.");
+    recordingLayout->addRow("File Codec:", m_pathCodecComboBox);
+
+    m_suppressStationaryCheckBox = new QCheckBox();
+    m_suppressStationaryCheckBox->setToolTip("Only store samples where the cursor moved.\nHolds are kept as timing between changes, so playback is unchanged.");
+    recordingLayout->addRow("Skip Stationary Samples:", m_suppressStationaryCheckBox);
+
+    m_flightRecorderCheckBox = new QCheckBox();
+    m_flightRecorderCheckBox->setToolTip("Always keep the last seconds of cursor motion in a fixed-size buffer.\nThe flight recorder hotkey saves them and continues recording.");
+    recordingLayout->addRow("Flight Recorder:", m_flightRecorderCheckBox);
+
+    m_flightRecorderSecondsSpinBox = new QSpinBox();
+    m_flightRecorderSecondsSpinBox->setRange(1, MouseRecorder::MAX_PRE_ROLL_SECONDS);
+    m_flightRecorderSecondsSpinBox->setSuffix(" s");
+    m_flightRecorderSecondsSpinBox->setToolTip("How much motion before the hotkey press is kept");
+    recordingLayout->addRow("Pre-roll:", m_flightRecorderSecondsSpinBox);
+
+    m_memoryBudgetSpinBox = new QSpinBox();
+    m_memoryBudgetSpinBox->setRange(1, 4096);
+    m_memoryBudgetSpinBox->setSuffix(" MB");
+    m_memoryBudgetSpinBox->setToolTip("Recording stops when the in-memory recording reaches this size.\nNot used when streaming to disk.");
+    recordingLayout->addRow("Memory Budget:", m_memoryBudgetSpinBox);
+
     m_maxDurationLabel = new QLabel();
     m_maxDurationLabel->setStyleSheet("color: #666666; font-style: italic;");
     m_maxDurationLabel->setWordWrap(true);
@@ -67,6 +184,12 @@ void SettingsDialog::setupUI()
     m_minimizeCheckBox->setToolTip("Minimize to system tray when closed");
     appLayout->addRow("Minimize to Tray:", m_minimizeCheckBox);
 
+    m_progressRateSpinBox = new QSpinBox();
+    m_progressRateSpinBox->setRange(1, 100);
+    m_progressRateSpinBox->setSuffix(" Hz");
+    m_progressRateSpinBox->setToolTip("How often recording and playback progress is shown.\nIndependent of the recording interval.");
+    appLayout->addRow("UI Refresh Rate:", m_progressRateSpinBox);
+
     // Buttons
     QHBoxLayout *buttonLayout = new QHBoxLayout();
 
@@ -92,6 +215,15 @@ void SettingsDialog::setupUI()
     connect(m_cancelButton, &QPushButton::clicked, this, &SettingsDialog::onCancelClicked);
     connect(m_restoreDefaultsButton, &QPushButton::clicked, this, &SettingsDialog::onRestoreDefaultsClicked);
     connect(m_intervalSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsDialog::onIntervalValueChanged);
+    connect(m_streamToDiskCheckBox, &QCheckBox::toggled, this, &SettingsDialog::updateMaxDurationDisplay);
+    connect(m_streamToDiskCheckBox, &QCheckBox::toggled, m_memoryBudgetSpinBox, &QSpinBox::setDisabled);
+    connect(m_streamToDiskCheckBox, &QCheckBox::toggled, m_segmentSizeSpinBox, &QSpinBox::setEnabled);
+    connect(m_streamToDiskCheckBox, &QCheckBox::toggled, m_segmentPointsSpinBox, &QSpinBox::setEnabled);
+    connect(m_streamToDiskCheckBox, &QCheckBox::toggled, m_segmentMinutesSpinBox, &QSpinBox::setEnabled);
+    connect(m_memoryBudgetSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsDialog::updateMaxDurationDisplay);
+    connect(m_flightRecorderCheckBox, &QCheckBox::toggled, m_flightRecorderSecondsSpinBox, &QSpinBox::setEnabled);
+    connect(m_adaptiveRateCheckBox, &QCheckBox::toggled, m_velocityBoostCheckBox, &QCheckBox::setEnabled);
+    connect(m_calibrateButton, &QPushButton::clicked, this, &SettingsDialog::onCalibrateClicked);
 }
 
 // 加载设置：从注册表加载并应用到UI控件
@@ -100,14 +232,48 @@ void SettingsDialog::loadSettings()
     // Load settings with defaults
     QString hotkey = m_settings->value("hotkey", "Ctrl+B").toString();
     int interval = m_settings->value("recordingInterval", 50).toInt();
+    int captureMode = getCaptureMode();
+    bool streamToDisk = getStreamToDisk();
+    bool suppressStationary = getSuppressStationary();
+    bool adaptiveRate = getAdaptiveRate();
+    bool velocityBoost = getVelocityBoost();
+    bool flightRecorder = getFlightRecorderEnabled();
+    int flightSeconds = getFlightRecorderSeconds();
+    QString flightHotkey = getFlightRecorderHotkey();
     double speed = m_settings->value("defaultSpeed", 1.0).toDouble();
     bool minimize = m_settings->value("minimizeToTray", false).toBool();
+    int progressRate = getProgressRate();
+    double cpuBudget = getCalibrationCpuBudget();
+    double jitterBound = getCalibrationJitterBound();
 
     // Set UI values
     m_hotkeyEdit->setKeySequence(QKeySequence(hotkey));
     m_intervalSpinBox->setValue(interval);
+    m_captureModeComboBox->setCurrentIndex(qMax(0, m_captureModeComboBox->findData(captureMode)));
+    m_streamToDiskCheckBox->setChecked(streamToDisk);
+    m_memoryBudgetSpinBox->setValue(static_cast<int>(getMemoryBudget() / (1024 * 1024)));
+    m_memoryBudgetSpinBox->setDisabled(streamToDisk);
+    m_segmentSizeSpinBox->setValue(m_settings->value("segmentMaxMB", 0).toInt());
+    m_segmentPointsSpinBox->setValue(getSegmentMaxPoints());
+    m_segmentMinutesSpinBox->setValue(m_settings->value("segmentMaxMinutes", 0).toInt());
+    m_segmentSizeSpinBox->setEnabled(streamToDisk);
+    m_segmentPointsSpinBox->setEnabled(streamToDisk);
+    m_segmentMinutesSpinBox->setEnabled(streamToDisk);
+    m_pathCodecComboBox->setCurrentIndex(qMax(0, m_pathCodecComboBox->findData(getPathCodec())));
+    m_suppressStationaryCheckBox->setChecked(suppressStationary);
+    m_adaptiveRateCheckBox->setChecked(adaptiveRate);
+    m_velocityBoostCheckBox->setChecked(velocityBoost);
+    m_velocityBoostCheckBox->setEnabled(adaptiveRate);
+    m_flightRecorderCheckBox->setChecked(flightRecorder);
+    m_flightRecorderSecondsSpinBox->setValue(flightSeconds);
+    m_flightRecorderSecondsSpinBox->setEnabled(flightRecorder);
+    m_flightHotkeyEdit->setKeySequence(QKeySequence(flightHotkey));
     m_speedSpinBox->setValue(speed);
     m_minimizeCheckBox->setChecked(minimize);
+    m_progressRateSpinBox->setValue(progressRate);
+    m_cpuBudgetSpinBox->setValue(cpuBudget);
+    m_jitterBoundSpinBox->setValue(qRound(jitterBound));
+    updateCalibrationDisplay(getLastCalibration());
 
     // Update max duration display
     updateMaxDurationDisplay();
@@ -118,8 +284,24 @@ void SettingsDialog::saveSettings()
 {
     m_settings->setValue("hotkey", m_hotkeyEdit->keySequence().toString());
     m_settings->setValue("recordingInterval", m_intervalSpinBox->value());
+    m_settings->setValue("captureMode", m_captureModeComboBox->currentData().toInt());
+    m_settings->setValue("streamToDisk", m_streamToDiskCheckBox->isChecked());
+    m_settings->setValue("memoryBudgetMB", m_memoryBudgetSpinBox->value());
+    m_settings->setValue("segmentMaxMB", m_segmentSizeSpinBox->value());
+    m_settings->setValue("segmentMaxPoints", m_segmentPointsSpinBox->value());
+    m_settings->setValue("segmentMaxMinutes", m_segmentMinutesSpinBox->value());
+    m_settings->setValue("pathCodec", m_pathCodecComboBox->currentData().toInt());
+    m_settings->setValue("suppressStationary", m_suppressStationaryCheckBox->isChecked());
+    m_settings->setValue("adaptiveRate", m_adaptiveRateCheckBox->isChecked());
+    m_settings->setValue("velocityBoost", m_velocityBoostCheckBox->isChecked());
+    m_settings->setValue("flightRecorderEnabled", m_flightRecorderCheckBox->isChecked());
+    m_settings->setValue("flightRecorderSeconds", m_flightRecorderSecondsSpinBox->value());
+    m_settings->setValue("flightRecorderHotkey", m_flightHotkeyEdit->keySequence().toString());
     m_settings->setValue("defaultSpeed", m_speedSpinBox->value());
     m_settings->setValue("minimizeToTray", m_minimizeCheckBox->isChecked());
+    m_settings->setValue("progressRate", m_progressRateSpinBox->value());
+    m_settings->setValue("calibrationCpuBudget", m_cpuBudgetSpinBox->value());
+    m_settings->setValue("calibrationJitterBound", m_jitterBoundSpinBox->value());
     m_settings->sync();
 }
 
@@ -128,8 +310,24 @@ void SettingsDialog::restoreDefaults()
 {
     m_hotkeyEdit->setKeySequence(QKeySequence("Ctrl+B"));
     m_intervalSpinBox->setValue(50);
+    m_captureModeComboBox->setCurrentIndex(0);
+    m_streamToDiskCheckBox->setChecked(false);
+    m_memoryBudgetSpinBox->setValue(static_cast<int>(MouseRecorder::DEFAULT_MEMORY_BUDGET / (1024 * 1024)));
+    m_segmentSizeSpinBox->setValue(0);
+    m_segmentPointsSpinBox->setValue(0);
+    m_segmentMinutesSpinBox->setValue(0);
+    m_pathCodecComboBox->setCurrentIndex(0);
+    m_suppressStationaryCheckBox->setChecked(false);
+    m_adaptiveRateCheckBox->setChecked(false);
+    m_velocityBoostCheckBox->setChecked(false);
+    m_flightRecorderCheckBox->setChecked(false);
+    m_flightRecorderSecondsSpinBox->setValue(10);
+    m_flightHotkeyEdit->setKeySequence(QKeySequence("Ctrl+Shift+B"));
     m_speedSpinBox->setValue(1.0);
     m_minimizeCheckBox->setChecked(false);
+    m_progressRateSpinBox->setValue(30);
+    m_cpuBudgetSpinBox->setValue(2.0);
+    m_jitterBoundSpinBox->setValue(25);
 }
 
 // 获取录制热键设置
@@ -144,12 +342,125 @@ int SettingsDialog::getRecordingInterval() const
     return m_settings->value("recordingInterval", 50).toInt();
 }
 
+// 获取采集模式设置（不支持事件采集时回退为定时轮询）
+int SettingsDialog::getCaptureMode() const
+{
+    int mode = m_settings->value("captureMode", MouseRecorder::PollingCapture).toInt();
+    if (mode == MouseRecorder::EventCapture && !PointerEventSource::isNativeSupported()) {
+        return MouseRecorder::PollingCapture;
+    }
+    return mode;
+}
+
+// 获取是否流式写入磁盘设置
+bool SettingsDialog::getStreamToDisk() const
+{
+    return m_settings->value("streamToDisk", false).toBool();
+}
+
+// 获取分段文件大小上限（字节，0表示不限制）
+qint64 SettingsDialog::getSegmentMaxBytes() const
+{
+    return m_settings->value("segmentMaxMB", 0).toLongLong() * 1024 * 1024;
+}
+
+// 获取分段点数上限（0表示不限制）
+int SettingsDialog::getSegmentMaxPoints() const
+{
+    return m_settings->value("segmentMaxPoints", 0).toInt();
+}
+
+// 获取分段时长上限（毫秒，0表示不限制）
+qint64 SettingsDialog::getSegmentMaxDurationMs() const
+{
+    return m_settings->value("segmentMaxMinutes", 0).toLongLong() * 60 * 1000;
+}
+
+// 获取新文件使用的编解码器
+int SettingsDialog::getPathCodec() const
+{
+    return m_settings->value("pathCodec", PathCodec::DEFAULT_CODEC).toInt();
+}
+
+// 获取录制内存预算（字节）
+qint64 SettingsDialog::getMemoryBudget() const
+{
+    qint64 defaultMB = MouseRecorder::DEFAULT_MEMORY_BUDGET / (1024 * 1024);
+    return m_settings->value("memoryBudgetMB", defaultMB).toLongLong() * 1024 * 1024;
+}
+
+// 获取上次录制实测的每个样本字节数（0表示尚未测量）
+double SettingsDialog::getMeasuredBytesPerSample() const
+{
+    return m_settings->value("measuredBytesPerSample", 0.0).toDouble();
+}
+
+// 获取是否跳过静止样本设置
+bool SettingsDialog::getSuppressStationary() const
+{
+    return m_settings->value("suppressStationary", false).toBool();
+}
+
+// 获取是否启用自适应采样频率设置
+bool SettingsDialog::getAdaptiveRate() const
+{
+    return m_settings->value("adaptiveRate", false).toBool();
+}
+
+// 获取是否在快速移动时提高采样频率设置
+bool SettingsDialog::getVelocityBoost() const
+{
+    return m_settings->value("velocityBoost", false).toBool();
+}
+
+// 获取是否启用飞行记录器设置
+bool SettingsDialog::getFlightRecorderEnabled() const
+{
+    return m_settings->value("flightRecorderEnabled", false).toBool();
+}
+
+// 获取飞行记录器预录时长设置（秒）
+int SettingsDialog::getFlightRecorderSeconds() const
+{
+    return m_settings->value("flightRecorderSeconds", 10).toInt();
+}
+
+// 获取飞行记录器保存热键设置
+QString SettingsDialog::getFlightRecorderHotkey() const
+{
+    return m_settings->value("flightRecorderHotkey", "Ctrl+Shift+B").toString();
+}
+
 // 获取默认播放速度设置
 double SettingsDialog::getDefaultPlaybackSpeed() const
 {
     return m_settings->value("defaultSpeed", 1.0).toDouble();
 }
 
+// 获取界面进度刷新频率设置
+int SettingsDialog::getProgressRate() const
+{
+    return m_settings->value("progressRate", 30).toInt();
+}
+
+// 获取校准使用的CPU预算（百分比）
+double SettingsDialog::getCalibrationCpuBudget() const
+{
+    return m_settings->value("calibrationCpuBudget", 2.0).toDouble();
+}
+
+// 获取校准使用的抖动上限（目标间隔的百分比）
+double SettingsDialog::getCalibrationJitterBound() const
+{
+    return m_settings->value("calibrationJitterBound", 25).toDouble();
+}
+
+// 获取上一次的校准结果
+CalibrationResult SettingsDialog::getLastCalibration() const
+{
+    return CalibrationResult::load(m_settings);
+}
+
 // 获取是否最小化到系统托盘设置
 bool SettingsDialog::getMinimizeToTray() const
 {
@@ -170,6 +481,94 @@ void SettingsDialog::setRecordingInterval(int interval)
     m_intervalSpinBox->setValue(interval);
 }
 
+// 设置采集模式
+void SettingsDialog::setCaptureMode(int mode)
+{
+    m_settings->setValue("captureMode", mode);
+    m_captureModeComboBox->setCurrentIndex(qMax(0, m_captureModeComboBox->findData(mode)));
+}
+
+// 设置是否流式写入磁盘
+void SettingsDialog::setStreamToDisk(bool enabled)
+{
+    m_settings->setValue("streamToDisk", enabled);
+    m_streamToDiskCheckBox->setChecked(enabled);
+}
+
+// 设置分段滚动阈值
+void SettingsDialog::setSegmentLimits(qint64 maxBytes, int maxPoints, qint64 maxDurationMs)
+{
+    m_settings->setValue("segmentMaxMB", maxBytes / (1024 * 1024));
+    m_settings->setValue("segmentMaxPoints", maxPoints);
+    m_settings->setValue("segmentMaxMinutes", maxDurationMs / (60 * 1000));
+    m_segmentSizeSpinBox->setValue(static_cast<int>(maxBytes / (1024 * 1024)));
+    m_segmentPointsSpinBox->setValue(maxPoints);
+    m_segmentMinutesSpinBox->setValue(static_cast<int>(maxDurationMs / (60 * 1000)));
+}
+
+// 设置新文件使用的编解码器
+void SettingsDialog::setPathCodec(int codecId)
+{
+    m_settings->setValue("pathCodec", codecId);
+    m_pathCodecComboBox->setCurrentIndex(qMax(0, m_pathCodecComboBox->findData(codecId)));
+}
+
+// 设置录制内存预算（字节）
+void SettingsDialog::setMemoryBudget(qint64 bytes)
+{
+    m_settings->setValue("memoryBudgetMB", bytes / (1024 * 1024));
+    m_memoryBudgetSpinBox->setValue(static_cast<int>(bytes / (1024 * 1024)));
+}
+
+// 保存实测的每个样本字节数
+void SettingsDialog::setMeasuredBytesPerSample(double bytes)
+{
+    m_settings->setValue("measuredBytesPerSample", bytes);
+    updateMaxDurationDisplay();
+}
+
+// 设置是否跳过静止样本
+void SettingsDialog::setSuppressStationary(bool enabled)
+{
+    m_settings->setValue("suppressStationary", enabled);
+    m_suppressStationaryCheckBox->setChecked(enabled);
+}
+
+// 设置是否启用自适应采样频率
+void SettingsDialog::setAdaptiveRate(bool enabled)
+{
+    m_settings->setValue("adaptiveRate", enabled);
+    m_adaptiveRateCheckBox->setChecked(enabled);
+}
+
+// 设置是否在快速移动时提高采样频率
+void SettingsDialog::setVelocityBoost(bool enabled)
+{
+    m_settings->setValue("velocityBoost", enabled);
+    m_velocityBoostCheckBox->setChecked(enabled);
+}
+
+// 设置是否启用飞行记录器
+void SettingsDialog::setFlightRecorderEnabled(bool enabled)
+{
+    m_settings->setValue("flightRecorderEnabled", enabled);
+    m_flightRecorderCheckBox->setChecked(enabled);
+}
+
+// 设置飞行记录器预录时长（秒）
+void SettingsDialog::setFlightRecorderSeconds(int seconds)
+{
+    m_settings->setValue("flightRecorderSeconds", seconds);
+    m_flightRecorderSecondsSpinBox->setValue(seconds);
+}
+
+// 设置飞行记录器保存热键
+void SettingsDialog::setFlightRecorderHotkey(const QString& hotkey)
+{
+    m_settings->setValue("flightRecorderHotkey", hotkey);
+    m_flightHotkeyEdit->setKeySequence(QKeySequence(hotkey));
+}
+
 // 设置默认播放速度
 void SettingsDialog::setDefaultPlaybackSpeed(double speed)
 {
@@ -177,6 +576,13 @@ void SettingsDialog::setDefaultPlaybackSpeed(double speed)
     m_speedSpinBox->setValue(speed);
 }
 
+// 设置界面进度刷新频率
+void SettingsDialog::setProgressRate(int hz)
+{
+    m_settings->setValue("progressRate", hz);
+    m_progressRateSpinBox->setValue(hz);
+}
+
 // 设置是否最小化到系统托盘
 void SettingsDialog::setMinimizeToTray(bool minimize)
 {
@@ -231,6 +637,59 @@ void SettingsDialog::onIntervalEditingFinished()
     }
 }
 
+// 校准按钮点击处理：在后台线程测量本机采集能力，完成后自动选择录制间隔
+void SettingsDialog::onCalibrateClicked()
+{
+    m_calibrateButton->setEnabled(false);
+    m_calibrationLabel->setText("Calibrating, keep the mouse still...");
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    // The trials take a few seconds; the dialog keeps painting while they run
+    double cpuBudget = m_cpuBudgetSpinBox->value();
+    double jitterBound = m_jitterBoundSpinBox->value();
+    QFutureWatcher<CalibrationResult> *watcher = new QFutureWatcher<CalibrationResult>(this);
+    connect(watcher, &QFutureWatcher<CalibrationResult>::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        QApplication::restoreOverrideCursor();
+        m_calibrateButton->setEnabled(true);
+
+        CalibrationResult result = watcher->result();
+        result.save(m_settings);
+        updateCalibrationDisplay(result);
+
+        // Auto-select: the interval spin box still needs OK to be applied
+        if (result.recommendedIntervalMs > 0) {
+            m_validationTimer->blockSignals(true);
+            m_intervalSpinBox->setValue(result.recommendedIntervalMs);
+            m_validationTimer->stop();
+            m_validationTimer->blockSignals(false);
+        }
+    });
+    watcher->setFuture(QtConcurrent::run([cpuBudget, jitterBound]() {
+        return CaptureCalibrator::calibrate(cpuBudget, jitterBound);
+    }));
+}
+
+// 更新校准结果显示
+void SettingsDialog::updateCalibrationDisplay(const CalibrationResult& result)
+{
+    if (!result.isValid()) {
+        m_calibrationLabel->setText("Not calibrated on this machine");
+        m_calibrationLabel->setToolTip(QString());
+        return;
+    }
+
+    QString text = result.recommendedIntervalMs > 0
+                   ? QString("Recommended: %1 ms").arg(result.recommendedIntervalMs)
+                   : QString("No interval within budget");
+    text += QString(" (sample cost %1 us, sleep overshoot %2 us)")
+            .arg(QString::number(result.sampleCostUs, 'f', 1))
+            .arg(QString::number(result.sleepOvershootUs, 'f', 0));
+
+    m_calibrationLabel->setText(text);
+    m_calibrationLabel->setToolTip(result.summary());
+}
+
 // 显示间隔警告：对低间隔设置显示性能警告
 void SettingsDialog::showIntervalWarning(int interval)
 {
@@ -260,13 +719,23 @@ void SettingsDialog::updateMaxDurationDisplay()
 {
     if (!m_maxDurationLabel) return;
 
+    // Streamed recordings only keep one block in memory
+    if (m_streamToDiskCheckBox && m_streamToDiskCheckBox->isChecked()) {
+        m_maxDurationLabel->setText("Unlimited (streamed to disk)");
+        return;
+    }
+
     int intervalMs = m_intervalSpinBox->value();
-    const int MAX_POINTS = 300000; // Same as MouseRecorder::MAX_RECORDING_POINTS
+    qint64 budgetBytes = static_cast<qint64>(m_memoryBudgetSpinBox->value()) * 1024 * 1024;
+
+    // Bytes per sample measured by the last in-memory recording, or a typical value
+    double measured = getMeasuredBytesPerSample();
+    double bytesPerSample = measured > 0.0 ? measured : 6.0;
 
     // Calculate maximum recording duration
-    // Points per second = 1000 / intervalMs
-    // Max seconds = MAX_POINTS / (1000 / intervalMs) = MAX_POINTS * intervalMs / 1000
-    double maxSeconds = (double)MAX_POINTS * intervalMs / 1000.0;
+    // Max points = usable budget / bytes per sample; points per second = 1000 / intervalMs
+    double maxPoints = qMax(0LL, budgetBytes - SampleStore::FIXED_BYTES) / bytesPerSample;
+    double maxSeconds = maxPoints * intervalMs / 1000.0;
 
     QString durationText;
     if (maxSeconds < 60) {
@@ -281,9 +750,10 @@ void SettingsDialog::updateMaxDurationDisplay()
         durationText = QString("%1h %2m").arg(hours).arg(minutes);
     }
 
-    // Add memory usage info
-    double memoryMB = MAX_POINTS * 32.0 / (1024.0 * 1024.0); // 32 bytes per point
-    QString memoryText = QString::number(memoryMB, 'f', 1);
+    // Add per-sample cost info
+    QString costText = measured > 0.0
+                       ? QString("%1 B/sample measured").arg(QString::number(measured, 'f', 1))
+                       : QString("≈%1 B/sample estimated").arg(QString::number(bytesPerSample, 'f', 0));
 
-    m_maxDurationLabel->setText(QString("≈ %1 (≈%2 MB memory)").arg(durationText).arg(memoryText));
+    m_maxDurationLabel->setText(QString("≈ %1 (%2)").arg(durationText).arg(costText));
 }
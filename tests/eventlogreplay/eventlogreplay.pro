@@ -0,0 +1,67 @@
+QT       += core gui testlib concurrent
+
+CONFIG += c++17 testcase
+CONFIG -= app_bundle
+
+TARGET = tst_eventlogreplay
+
+# Recorder sources under test, built from the application tree
+INCLUDEPATH += ../../include
+
+SOURCES += \
+    tst_eventlogreplay.cpp \
+    ../../src/mousepoint.cpp \
+    ../../src/mouserecorder.cpp \
+    ../../src/pathmanager.cpp \
+    ../../src/pointereventsource.cpp \
+    ../../src/capturethread.cpp \
+    ../../src/pathstreamwriter.cpp \
+    ../../src/capturestats.cpp \
+    ../../src/samplestore.cpp \
+    ../../src/pathbuffer.cpp \
+    ../../src/editlist.cpp \
+    ../../src/pathcodec.cpp \
+    ../../src/crc32c.cpp \
+    ../../src/pathsummary.cpp
+
+HEADERS += \
+    ../../include/mousepoint.h \
+    ../../include/mouserecorder.h \
+    ../../include/pathmanager.h \
+    ../../include/pointereventsource.h \
+    ../../include/capturethread.h \
+    ../../include/spscringbuffer.h \
+    ../../include/pathstreamwriter.h \
+    ../../include/capturestats.h \
+    ../../include/samplestore.h \
+    ../../include/pathbuffer.h \
+    ../../include/editlist.h \
+    ../../include/pathcodec.h \
+    ../../include/crc32c.h \
+    ../../include/pathsummary.h
+
+DISTFILES += \
+    stroke.log
+
+win32 {
+    LIBS += -luser32 -lgdi32 -lwinmm
+}
+
+# The replay source needs no window system; run with QT_QPA_PLATFORM=offscreen where there is none
+unix:!macx {
+    CONFIG += link_pkgconfig
+    # Thread-safe cursor queries on a private X connection
+    packagesExist(x11) {
+        PKGCONFIG += x11
+        DEFINES += HAVE_X11
+    }
+    packagesExist(x11 xi) {
+        PKGCONFIG += xi
+        DEFINES += HAVE_XINPUT2
+    }
+}
+
+# macOS: CGEventGetLocation for cursor queries off the GUI thread
+macx {
+    LIBS += -framework ApplicationServices
+}
@@ -0,0 +1,146 @@
+#include <QtTest>
+#include <QTemporaryFile>
+#include "mouserecorder.h"
+#include "pointereventsource.h"
+
+// 事件日志回放测试：日志经由MouseRecorder的事件驱动采集录制为路径
+class EventLogReplayTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void loadLogSkipsCommentsAndMalformedLines();
+    void replayRecordsLoggedPointsAndTimestamps();
+    void emptyLogFallsBackToPolling();
+    void unreachableDisplayFallsBackToPolling();
+};
+
+namespace {
+
+// Contents of stroke.log
+struct LoggedEvent
+{
+    qint64 offsetUs;
+    QPoint position;
+};
+
+const LoggedEvent STROKE[] = {
+    { 0,     QPoint(100, 200) },
+    { 1500,  QPoint(104, 203) },
+    { 3000,  QPoint(111, 207) },
+    { 3250,  QPoint(112, 207) },
+    { 8000,  QPoint(130, 215) },
+    { 20000, QPoint(160, 230) },
+};
+const int STROKE_EVENTS = sizeof(STROKE) / sizeof(STROKE[0]);
+
+} // namespace
+
+void EventLogReplayTest::loadLogSkipsCommentsAndMalformedLines()
+{
+    QTemporaryFile log;
+    QVERIFY(log.open());
+    log.write("# comment\n"
+              "\n"
+              "0 10 20\n"
+              "not an event\n"
+              "100 x 20\n"
+              "200 10 20 30\n"
+              "  300   11   21  \n");
+    log.close();
+
+    EventLogPointerSource source;
+    QVERIFY(source.loadLog(log.fileName()));
+    QCOMPARE(source.eventCount(), 2);
+}
+
+void EventLogReplayTest::replayRecordsLoggedPointsAndTimestamps()
+{
+    EventLogPointerSource *source = new EventLogPointerSource;
+    QVERIFY(source->loadLog(QFINDTESTDATA("stroke.log")));
+    QCOMPARE(source->eventCount(), STROKE_EVENTS);
+
+    MouseRecorder recorder;
+    recorder.setCaptureMode(MouseRecorder::EventCapture);
+    recorder.setPointerEventSource(source);
+
+    recorder.startRecording();
+    QVERIFY(recorder.isRecording());
+    QTRY_VERIFY_WITH_TIMEOUT(!source->isRunning(), 5000);
+    recorder.stopRecording();
+
+    PathHandle path = recorder.takeRecordedPath();
+    QVERIFY(path);
+
+    // The cursor position at start, one point per logged event, then the point that
+    // closes the final hold
+    QCOMPARE(path->size(), STROKE_EVENTS + 2);
+    QCOMPARE(path->timestampNs(0), 0LL);
+
+    // Replayed events carry their logged offsets, so intervals are exact
+    qint64 firstEventNs = path->timestampNs(1);
+    QVERIFY(firstEventNs >= 0);
+    for (int i = 0; i < STROKE_EVENTS; ++i) {
+        QCOMPARE(path->position(i + 1), STROKE[i].position);
+        QCOMPARE(path->timestampNs(i + 1) - firstEventNs, STROKE[i].offsetUs * 1000);
+    }
+
+    int last = path->size() - 1;
+    QCOMPARE(path->position(last), STROKE[STROKE_EVENTS - 1].position);
+    QVERIFY(path->timestampNs(last) >= path->timestampNs(last - 1));
+}
+
+void EventLogReplayTest::emptyLogFallsBackToPolling()
+{
+    QTemporaryFile log;
+    QVERIFY(log.open());
+    log.write("# no events\n");
+    log.close();
+
+    EventLogPointerSource *source = new EventLogPointerSource;
+    QVERIFY(!source->loadLog(log.fileName()));
+
+    MouseRecorder recorder;
+    recorder.setRecordingInterval(5);
+    recorder.setCaptureMode(MouseRecorder::EventCapture);
+    recorder.setPointerEventSource(source);
+
+    // A source that cannot start leaves recording to the capture thread
+    recorder.startRecording();
+    QTRY_VERIFY_WITH_TIMEOUT(recorder.captureStats().sampleCount > 0, 5000);
+    recorder.stopRecording();
+    QVERIFY(!source->isRunning());
+}
+
+void EventLogReplayTest::unreachableDisplayFallsBackToPolling()
+{
+    // The XInput2 source connects from start(); only its own connection sees this value
+    QByteArray display = qgetenv("DISPLAY");
+    qputenv("DISPLAY", ":unreachable");
+
+    XInput2PointerSource *source = new XInput2PointerSource;
+    QSignalSpy errors(source, &PointerEventSource::sourceError);
+    QVERIFY(!source->start());
+    QVERIFY(!source->isRunning());
+    QCOMPARE(errors.count(), 1);
+
+    MouseRecorder recorder;
+    recorder.setRecordingInterval(5);
+    recorder.setCaptureMode(MouseRecorder::EventCapture);
+    recorder.setPointerEventSource(source);
+
+    recorder.startRecording();
+    QTRY_VERIFY_WITH_TIMEOUT(recorder.captureStats().sampleCount > 0, 5000);
+    recorder.stopRecording();
+    QVERIFY(!source->isRunning());
+
+    if (display.isNull()) {
+        qunsetenv("DISPLAY");
+    } else {
+        qputenv("DISPLAY", display);
+    }
+}
+
+QTEST_MAIN(EventLogReplayTest)
+
+#include "tst_eventlogreplay.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = subdirs
+
+# Unit tests; build with qmake tests/tests.pro and run with make check
+SUBDIRS += \
+    eventlogreplay